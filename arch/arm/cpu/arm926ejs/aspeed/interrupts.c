@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#include <common.h>
+#include <asm/io.h>
+#include <asm/arch/irq.h>
+#include <asm/proc-armv/ptrace.h>
+
+#ifdef CONFIG_USE_IRQ
+
+DECLARE_GLOBAL_DATA_PTR;
+
+struct irq_action {
+	interrupt_handler_t *handler;
+	void *data;
+};
+
+static struct irq_action irq_actions[AST_NR_IRQS];
+static struct pt_regs *irq_regs;
+
+struct pt_regs *get_irq_regs(void)
+{
+	return irq_regs;
+}
+
+void do_irq(struct pt_regs *regs)
+{
+	ulong status = readl(AST_VIC_IRQ_STATUS);
+	int irq;
+
+	irq_regs = regs;
+	for (irq = 0; status; irq++, status >>= 1) {
+		struct irq_action *action = &irq_actions[irq];
+
+		if (!(status & 1))
+			continue;
+		writel(1UL << irq, AST_VIC_EDGE_CLEAR);
+		if (action->handler)
+			action->handler(action->data);
+		else
+			writel(1UL << irq, AST_VIC_DISABLE);
+	}
+	irq_regs = NULL;
+}
+
+void irq_install_handler(int irq, interrupt_handler_t *handler, void *data)
+{
+	if (irq < 0 || irq >= AST_NR_IRQS)
+		return;
+
+	writel(1UL << irq, AST_VIC_DISABLE);
+	irq_actions[irq].handler = handler;
+	irq_actions[irq].data = data;
+	if (handler)
+		writel(1UL << irq, AST_VIC_ENABLE);
+}
+
+void irq_free_handler(int irq)
+{
+	irq_install_handler(irq, NULL, NULL);
+}
+
+int arch_interrupt_init(void)
+{
+	/* Everything masked, and an IRQ rather than an FIQ when enabled */
+	writel(~0UL, AST_VIC_DISABLE);
+	writel(0, AST_VIC_SELECT);
+	writel(~0UL, AST_VIC_EDGE_CLEAR);
+
+	/*
+	 * The CPU takes exceptions at address 0, which board_init() has
+	 * mapped onto the start of DRAM. Put the relocated U-Boot's vectors
+	 * there, and make sure the I-cache no longer holds the ones in flash.
+	 */
+	memcpy((void *)CONFIG_SYS_SDRAM_BASE, (void *)gd->relocaddr,
+	       AST_VECTORS_SIZE);
+	flush_cache(CONFIG_SYS_SDRAM_BASE, AST_VECTORS_SIZE);
+	asm volatile("mcr p15, 0, %0, c7, c5, 0" : : "r" (0));
+
+	return 0;
+}
+
+#endif /* CONFIG_USE_IRQ */
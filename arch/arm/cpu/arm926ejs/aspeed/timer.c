@@ -16,27 +16,49 @@
  */
 
 #include <common.h>
+#include <div64.h>
+#include <errno.h>
+#include <profile.h>
+#include <timebase.h>
+#include <asm/io.h>
+#include <asm/arch/irq.h>
+#include <asm/proc-armv/ptrace.h>
 
 #if CONFIG_ASPEED_TIMER_CLK < CONFIG_SYS_HZ
 #error "CONFIG_ASPEED_TIMER_CLK must be as large as CONFIG_SYS_HZ"
 #endif
 
+DECLARE_GLOBAL_DATA_PTR;
+
 #define TIMER_LOAD_VAL 0xffffffff
 #define CLK_PER_HZ (CONFIG_ASPEED_TIMER_CLK / CONFIG_SYS_HZ)
+#define CLK_PER_US (CONFIG_ASPEED_TIMER_CLK / 1000000)
 
 /* macro to read the 32 bit timer */
 #define READ_CLK (*(volatile ulong *)(CONFIG_SYS_TIMERBASE + 0))
-#define READ_TIMER (READ_CLK / CLK_PER_HZ)
 
-static ulong timestamp;
-static ulong lastdec;
+/*
+ * Timer1 is a 32 bit down counter reloaded with TIMER_LOAD_VAL, so it
+ * has a period of exactly 2^32 clocks and the modular difference of two
+ * readings is the number of clocks elapsed between them.  The readings
+ * are folded into a 64 bit up-counter kept in gd (tbu:tbl), which is
+ * usable before relocation and only has to be sampled once per wrap
+ * (71 minutes at 1 MHz) to stay exact.
+ */
+#define lastdec		(gd->arch.lastinc)
+#define timebase_l	(gd->arch.tbl)
+#define timebase_h	(gd->arch.tbu)
+#define timer_base	(gd->arch.timer_reset_value)
 
 int timer_init (void)
 {
 	*(volatile ulong *)(CONFIG_SYS_TIMERBASE + 4)    = TIMER_LOAD_VAL;
 	*(volatile ulong *)(CONFIG_SYS_TIMERBASE + 0x30) = 0x3;		/* enable timer1 */
 
-	/* init the timestamp and lastdec value */
+	/* init the timebase and the get_timer() origin */
+	lastdec = READ_CLK;
+	timebase_l = 0;
+	timebase_h = 0;
 	reset_timer_masked();
 
 	return 0;
@@ -58,56 +80,59 @@ ulong get_timer (ulong base)
 
 void set_timer (ulong t)
 {
-	timestamp = t;
+	timer_base = get_ticks() - (unsigned long long)t * CLK_PER_HZ;
+}
+
+/*
+ * Convert a delay into timer clocks.  With the usual 1 MHz external
+ * clock this is a plain multiply, which keeps short delays short.
+ */
+static inline unsigned long long usec_to_clk(unsigned long usec)
+{
+#if CLK_PER_US && (CONFIG_ASPEED_TIMER_CLK % 1000000) == 0
+	return (unsigned long long)usec * CLK_PER_US;
+#else
+	return timebase_from_usec(usec, CONFIG_ASPEED_TIMER_CLK);
+#endif
+}
+
+/*
+ * Busy-wait for at least clks timer clocks.  The first reading may be
+ * taken just before the counter steps, so one extra clock is waited for
+ * to never return early.
+ */
+static void clk_delay(unsigned long long clks)
+{
+	unsigned long long end = get_ticks() + clks + 1;
+
+	while (get_ticks() < end)
+		;
 }
 
 /* delay x useconds AND perserve advance timstamp value */
 void __udelay (unsigned long usec)
 {
-  ulong last = READ_CLK;
-  ulong clks;
-  ulong elapsed = 0;
-
-  /* translate usec to clocks */
-  clks = (usec / 1000) * CLK_PER_HZ;
-  clks += (usec % 1000) * CLK_PER_HZ / 1000;
+	clk_delay(usec_to_clk(usec));
+}
 
-  while (clks > elapsed) {
-    ulong now = READ_CLK;
-    if (now <= last) {
-      elapsed += last - now;
-    } else {
-      elapsed += TIMER_LOAD_VAL - (now - last);
-    }
-    last = now;
-  }
+void __ndelay (unsigned long nsec)
+{
+#if CLK_PER_US == 1 && (CONFIG_ASPEED_TIMER_CLK % 1000000) == 0
+	clk_delay(DIV_ROUND_UP(nsec, 1000));
+#else
+	clk_delay(timebase_from_nsec(nsec, CONFIG_ASPEED_TIMER_CLK));
+#endif
 }
 
 void reset_timer_masked (void)
 {
-	/* reset time */
-	lastdec = READ_TIMER;  /* capure current decrementer value time */
-	timestamp = 0;	       /* start "advancing" time stamp from 0 */
+	/* start "advancing" get_timer() from 0, the timebase keeps running */
+	timer_base = get_ticks();
 }
 
 ulong get_timer_masked (void)
 {
-	ulong now = READ_TIMER;		/* current tick value */
-
-	if (lastdec >= now) {		/* normal mode (non roll) */
-		/* normal mode */
-		timestamp += lastdec - now; /* move stamp fordward with absoulte diff ticks */
-	} else {			/* we have overflow of the count down timer */
-		/* nts = ts + ld + (TLV - now)
-		 * ts=old stamp, ld=time that passed before passing through -1
-		 * (TLV-now) amount of time after passing though -1
-		 * nts = new "advancing time stamp"...it could also roll and cause problems.
-		 */
-		timestamp += lastdec + (TIMER_LOAD_VAL / CLK_PER_HZ) - now;
-	}
-	lastdec = now;
-
-	return timestamp;
+	return lldiv(get_ticks() - timer_base, CLK_PER_HZ);
 }
 
 /* waits specified delay value and resets timestamp */
@@ -117,12 +142,19 @@ void udelay_masked (unsigned long usec)
 }
 
 /*
- * This function is derived from PowerPC code (read timebase as long long).
- * On ARM it just returns the timer value.
+ * Return the 64 bit monotonic timebase in timer clocks.
  */
-unsigned long long get_ticks(void)
+unsigned long long __attribute__((no_instrument_function)) get_ticks(void)
 {
-	return get_timer(0);
+	ulong now = READ_CLK;
+	ulong last = timebase_l;
+
+	timebase_l += timebase_down_elapsed(lastdec, now);
+	if (timebase_l < last)		/* carry into the high word */
+		timebase_h++;
+	lastdec = now;
+
+	return ((unsigned long long)timebase_h << 32) | timebase_l;
 }
 
 /*
@@ -131,5 +163,89 @@ unsigned long long get_ticks(void)
  */
 ulong get_tbclk (void)
 {
-	return CONFIG_SYS_HZ;
+	return CONFIG_ASPEED_TIMER_CLK;
+}
+
+/*
+ * Return the number of microseconds since timer_init(). This timestamps
+ * function trace records, so nothing it calls may be instrumented.
+ */
+unsigned long __attribute__((no_instrument_function)) timer_get_us(void)
+{
+#if CLK_PER_US == 1
+	return get_ticks();
+#elif CLK_PER_US > 1
+	return lldiv(get_ticks(), CLK_PER_US);
+#else
+	return lldiv(get_ticks() * 1000000, CONFIG_ASPEED_TIMER_CLK);
+#endif
+}
+
+ulong timer_get_boot_us(void)
+{
+	return timer_get_us();
+}
+
+#ifdef CONFIG_PROFILE
+/* Timer2 interrupts hz times a second for the sampling profiler */
+#define TIMER2_COUNT		(CONFIG_SYS_TIMERBASE + 0x10)
+#define TIMER2_RELOAD		(CONFIG_SYS_TIMERBASE + 0x14)
+#define TIMER_CONTROL		(CONFIG_SYS_TIMERBASE + 0x30)
+#define TIMER2_CONTROL_MASK	(0xf << 4)
+#define TIMER2_CONTROL_RUN	(0x7 << 4)	/* enable, 1MHz, interrupt */
+
+/*
+ * U-Boot runs in SVC mode, whose banked lr is not among the registers
+ * saved on the way into the IRQ handler. Step into SVC mode for long
+ * enough to read it.
+ */
+static ulong __attribute__((no_instrument_function)) svc_lr(void)
+{
+	ulong cpsr, svc, lr;
+
+	asm volatile("mrs	%0, cpsr\n"
+		     "orr	%1, %0, #0x13\n"
+		     "msr	cpsr_c, %1\n"
+		     "mov	%2, lr\n"
+		     "msr	cpsr_c, %0\n"
+		     : "=&r" (cpsr), "=&r" (svc), "=&r" (lr)
+		     :
+		     : "lr");
+
+	return lr;
+}
+
+static void __attribute__((no_instrument_function))
+		profile_timer_irq(void *data)
+{
+	struct pt_regs *regs = get_irq_regs();
+	ulong caller = 0;
+
+	if (processor_mode(regs) == SVC_MODE)
+		caller = svc_lr();
+
+	/* The saved pc is 4 past the interrupted instruction */
+	profile_sample(instruction_pointer(regs) - 4, caller);
+}
+
+int profile_timer_start(unsigned int hz)
+{
+	ulong reload = CONFIG_ASPEED_TIMER_CLK / hz;
+
+	if (reload < 2)
+		return -EINVAL;
+
+	writel(reload - 1, TIMER2_RELOAD);
+	writel(reload - 1, TIMER2_COUNT);
+	irq_install_handler(AST_IRQ_TIMER2, profile_timer_irq, NULL);
+	clrsetbits_le32(TIMER_CONTROL, TIMER2_CONTROL_MASK, TIMER2_CONTROL_RUN);
+
+	return 0;
+}
+
+void profile_timer_stop(void)
+{
+	clrbits_le32(TIMER_CONTROL, TIMER2_CONTROL_MASK);
+	irq_free_handler(AST_IRQ_TIMER2);
 }
+#endif /* CONFIG_PROFILE */
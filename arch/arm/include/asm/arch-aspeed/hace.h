@@ -0,0 +1,173 @@
+/*
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _ASPEED_HACE_H
+#define _ASPEED_HACE_H
+
+#include <aes.h>
+
+/* Hash And Crypto Engine */
+#define HACE_BASE			0x1E6E3000
+
+#define HACE_CRYPTO_SRC			(HACE_BASE + 0x00)
+#define HACE_CRYPTO_DST			(HACE_BASE + 0x04)
+#define HACE_CRYPTO_CONTEXT		(HACE_BASE + 0x08)
+#define HACE_CRYPTO_LEN			(HACE_BASE + 0x0C)
+#define HACE_CRYPTO_CMD			(HACE_BASE + 0x10)
+#define HACE_STATUS			(HACE_BASE + 0x1C)
+#define HACE_HASH_SRC			(HACE_BASE + 0x20)
+#define HACE_HASH_DIGEST		(HACE_BASE + 0x24)
+#define HACE_HASH_KEY			(HACE_BASE + 0x28)
+#define HACE_HASH_LEN			(HACE_BASE + 0x2C)
+#define HACE_HASH_CMD			(HACE_BASE + 0x30)
+
+/* HACE_STATUS */
+#define HACE_HASH_BUSY			0x01
+#define HACE_CRYPTO_BUSY		0x02
+
+/* HACE_HASH_CMD */
+#define HACE_HASH_MD5			0x00
+#define HACE_HASH_SHA1			0x20
+#define HACE_HASH_SHA224		0x40
+#define HACE_HASH_SHA256		0x50
+#define HACE_HASH_SHA_SWAP		0x08	/* big-endian SHA digest */
+#define HACE_HASH_ACCUM			0x100	/* no padding, digest is state */
+#define HACE_HASH_INT_ENABLE		0x200
+
+/* HACE_CRYPTO_CMD */
+#define HACE_CRYPTO_AES128		0x00
+#define HACE_CRYPTO_AES192		0x04
+#define HACE_CRYPTO_AES256		0x08
+#define HACE_CRYPTO_ECB			0x00
+#define HACE_CRYPTO_CBC			0x10
+#define HACE_CRYPTO_CFB			0x20
+#define HACE_CRYPTO_OFB			0x30
+#define HACE_CRYPTO_CTR			0x40
+#define HACE_CRYPTO_ENCRYPT		0x80
+#define HACE_CRYPTO_AES			0x000
+#define HACE_CRYPTO_RC4			0x100
+
+/* SCU bits gating the engine */
+#define HACE_SCU_BASE			0x1E6E2000
+#define HACE_SCU_KEY			0x1688A8A8
+#define HACE_SCU_RESET			(1 << 4)	/* SCU04 */
+#define HACE_SCU_CLK_STOP		(1 << 13)	/* SCU0C */
+
+/* The engine fetches its source in 8 byte words */
+#define HACE_SRC_ALIGN			8
+#define HACE_HASH_BLOCK			64
+
+/* Cipher source, destination and context must be 16 byte aligned */
+#define HACE_CRYPTO_ALIGN		16
+#define HACE_AES_BLOCK			16
+
+/* Unaligned or partial data is staged through this many bytes */
+#define HACE_HASH_BUF_SIZE		1024
+
+enum hace_hash_algo {
+	HACE_ALGO_MD5,
+	HACE_ALGO_SHA1,
+	HACE_ALGO_SHA256,
+};
+
+/*
+ * Streaming hash context. In accumulative mode the engine neither pads
+ * nor finalises: it loads the running state from the digest buffer,
+ * processes whole blocks and writes the state back, so a message can be
+ * fed in any number of chunks and the padding is appended in software.
+ */
+struct hace_hash_ctx {
+	u8 digest[32] __aligned(ARCH_DMA_MINALIGN);
+	u8 buf[HACE_HASH_BUF_SIZE + 2 * HACE_HASH_BLOCK]
+		__aligned(ARCH_DMA_MINALIGN);
+	u32 cmd;
+	enum hace_hash_algo algo;
+	unsigned int digest_len;
+	unsigned int buf_len;		/* partial block held in buf */
+	u64 total;			/* message length so far */
+};
+
+/**
+ * Start a streaming hash
+ *
+ * @param ctx	Context to set up
+ * @param algo	Algorithm to use
+ * @return 0 if ok, -EINVAL for an unknown algorithm
+ */
+int hace_hash_init(struct hace_hash_ctx *ctx, enum hace_hash_algo algo);
+
+/**
+ * Add data to a streaming hash
+ *
+ * Word aligned data is hashed in place by the engine, anything else is
+ * copied into the context buffer first. Only a trailing partial block is
+ * kept in the buffer between calls.
+ *
+ * @param ctx	Context set up by hace_hash_init()
+ * @param data	Data to add
+ * @param len	Length of data in bytes
+ * @return 0 if ok, -ETIMEDOUT if the engine hung
+ */
+int hace_hash_update(struct hace_hash_ctx *ctx, const void *data,
+		     unsigned int len);
+
+/**
+ * Pad and finish a streaming hash
+ *
+ * @param ctx	Context set up by hace_hash_init()
+ * @param out	Receives ctx->digest_len bytes of digest
+ * @return 0 if ok, -ETIMEDOUT if the engine hung
+ */
+int hace_hash_finish(struct hace_hash_ctx *ctx, u8 *out);
+
+/*
+ * AES context. The engine reads the IV (or counter block) and the
+ * encryption key schedule from here; for decryption it derives the
+ * inverse schedule itself. The IV is advanced in software after each
+ * command so that a buffer can be processed as a sequence of calls.
+ */
+struct hace_aes_ctx {
+	u8 context[HACE_AES_BLOCK + AES_EXPAND_KEY_LENGTH]
+		__aligned(ARCH_DMA_MINALIGN);
+	u32 cmd;
+	enum aes_mode mode;
+};
+
+/**
+ * Set up an AES-128 context
+ *
+ * @param ctx	Context to set up
+ * @param mode	Chaining mode
+ * @param key	Key, AES_KEY_LENGTH bytes
+ * @param iv	Initial vector or counter block, NULL for ECB
+ * @return 0 if ok, -EINVAL for an unknown mode
+ */
+int hace_aes_init(struct hace_aes_ctx *ctx, enum aes_mode mode,
+		  u8 *key, const u8 *iv);
+
+/**
+ * Encrypt or decrypt with the engine
+ *
+ * Large buffers are split into several engine commands. ECB and CBC
+ * need a whole number of blocks; in CTR mode a partial block is only
+ * allowed on the last call for a stream.
+ *
+ * @param ctx	Context set up by hace_aes_init()
+ * @param encrypt	Non-zero to encrypt, zero to decrypt
+ * @param src	Input, HACE_CRYPTO_ALIGN aligned
+ * @param dst	Output, HACE_CRYPTO_ALIGN aligned, may equal src
+ * @param len	Length in bytes
+ * @return 0 if ok, -EINVAL for bad alignment or length, -ETIMEDOUT if
+ * the engine hung
+ */
+int hace_aes_crypt(struct hace_aes_ctx *ctx, int encrypt, const void *src,
+		   void *dst, unsigned int len);
+
+#endif /* _ASPEED_HACE_H */
@@ -0,0 +1,38 @@
+/*
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _ASPEED_IRQ_H
+#define _ASPEED_IRQ_H
+
+/* Vectored Interrupt Controller */
+#define AST_VIC_BASE			0x1E6C0000
+
+#define AST_VIC_IRQ_STATUS		(AST_VIC_BASE + 0x00)
+#define AST_VIC_RAW_STATUS		(AST_VIC_BASE + 0x08)
+#define AST_VIC_SELECT			(AST_VIC_BASE + 0x0C)	/* 1: FIQ */
+#define AST_VIC_ENABLE			(AST_VIC_BASE + 0x10)
+#define AST_VIC_DISABLE			(AST_VIC_BASE + 0x14)
+#define AST_VIC_EDGE_CLEAR		(AST_VIC_BASE + 0x38)
+
+#define AST_NR_IRQS			32
+
+#define AST_IRQ_TIMER1			16
+#define AST_IRQ_TIMER2			17
+#define AST_IRQ_TIMER3			18
+
+/* The vectors and the handler addresses they load, copied to DRAM */
+#define AST_VECTORS_SIZE		0x40
+
+struct pt_regs;
+
+/* The registers of the code the interrupt being handled interrupted */
+struct pt_regs *get_irq_regs(void);
+
+#endif /* _ASPEED_IRQ_H */
@@ -41,8 +41,11 @@
 #include <common.h>
 #include <command.h>
 #include <environment.h>
+#include <errno.h>
+#include <lazy_init.h>
 #include <malloc.h>
 #include <stdio_dev.h>
+#include <trace.h>
 #include <version.h>
 #include <net.h>
 #include <serial.h>
@@ -182,8 +185,25 @@ static int arm_pci_init(void)
 	pci_init();
 	return 0;
 }
+U_BOOT_LAZY_INIT(pci, arm_pci_init);
 #endif /* CONFIG_CMD_PCI || CONFIG_PCI */
 
+#if defined(CONFIG_CMD_NET)
+static int arm_eth_init(void)
+{
+	int devices;
+
+	puts("Net:   ");
+	devices = eth_initialize(gd->bd);
+#if defined(CONFIG_RESET_PHY_R)
+	debug("Reset Ethernet PHY\n");
+	reset_phy();
+#endif
+	return devices > 0 ? 0 : -ENODEV;
+}
+U_BOOT_LAZY_INIT(eth, arm_eth_init);
+#endif
+
 /*
  * Breathe some life into the board...
  *
@@ -233,17 +253,8 @@ int __power_init_board(void)
 int power_init_board(void)
 	__attribute__((weak, alias("__power_init_board")));
 
-	/* Record the board_init_f() bootstage (after arch_cpu_init()) */
-static int mark_bootstage(void)
-{
-	bootstage_mark_name(BOOTSTAGE_ID_START_UBOOT_F, "board_init_f");
-
-	return 0;
-}
-
 init_fnc_t *init_sequence[] = {
 	arch_cpu_init,		/* basic arch cpu dependent setup */
-	mark_bootstage,
 #ifdef CONFIG_OF_CONTROL
 	fdtdec_check_fdt,
 #endif
@@ -275,6 +286,55 @@ init_fnc_t *init_sequence[] = {
 	NULL,
 };
 
+#ifdef CONFIG_BOOTSTAGE
+/*
+ * bootstage keeps its records in .data, which may still be in flash
+ * during board_init_f(). So each init_sequence[] step only notes in gd
+ * when it finished, and board_init_r() hands the times to bootstage.
+ */
+static inline void init_f_mark(int step)
+{
+	if (step < GD_INIT_F_STEPS)
+		gd->init_f_us[step] = timer_get_boot_us();
+}
+
+static const char *init_f_name(init_fnc_t *fn)
+{
+	/* init_sequence[] was relocated along with the code */
+	ulong addr = (ulong)fn - gd->reloc_off;
+	char *name;
+#ifdef CONFIG_KALLSYMS
+	ulong base;
+	const char *sym = symbol_lookup(addr, &base);
+
+	if (sym && base == addr)
+		return sym;
+#endif
+	/* for looking up in System.map */
+	name = malloc(20);
+	if (name)
+		sprintf(name, "init_f %08lx", addr);
+
+	return name;
+}
+
+static void init_f_bootstage(void)
+{
+	int step;
+
+	/* The board_init_f() stage starts after arch_cpu_init() */
+	bootstage_add_record(BOOTSTAGE_ID_START_UBOOT_F, "board_init_f", 0,
+			     gd->init_f_us[0]);
+	for (step = 1; step < GD_INIT_F_STEPS && init_sequence[step]; step++)
+		bootstage_add_record(BOOTSTAGE_ID_ALLOC,
+				     init_f_name(init_sequence[step]),
+				     BOOTSTAGEF_ALLOC, gd->init_f_us[step]);
+}
+#else
+#define init_f_mark(step)
+#define init_f_bootstage()
+#endif
+
 void board_init_f(ulong bootflag)
 {
 	bd_t *bd;
@@ -305,6 +365,7 @@ void board_init_f(ulong bootflag)
 		if ((*init_fnc_ptr)() != 0) {
 			hang ();
 		}
+		init_f_mark(init_fnc_ptr - init_sequence);
 	}
 
 #ifdef CONFIG_OF_CONTROL
@@ -370,6 +431,13 @@ void board_init_f(ulong bootflag)
 	addr &= ~(4096 - 1);
 	debug("Top of RAM usable for U-Boot at: %08lx\n", addr);
 
+#ifdef CONFIG_TRACE
+	addr -= CONFIG_TRACE_BUFFER_SIZE;
+	gd->trace_buff = map_sysmem(addr, CONFIG_TRACE_BUFFER_SIZE);
+	debug("Reserving %dk for trace data at: %08lx\n",
+	      CONFIG_TRACE_BUFFER_SIZE >> 10, addr);
+#endif
+
 #ifdef CONFIG_LCD
 #ifdef CONFIG_FB_ADDR
 	gd->fb_base = CONFIG_FB_ADDR;
@@ -473,6 +541,39 @@ void board_init_f(ulong bootflag)
 
 #if !defined(CONFIG_SYS_NO_FLASH)
 static char *failed = "*** failed ***\n";
+
+static int arm_flash_init(void)
+{
+	ulong flash_size;
+
+	puts("Flash: ");
+
+	flash_size = flash_init();
+	if (flash_size > 0) {
+# ifdef CONFIG_SYS_FLASH_CHECKSUM
+		print_size(flash_size, "");
+		/*
+		 * Compute and print flash CRC if flashchecksum is set to 'y'
+		 *
+		 * NOTE: Maybe we should add some WATCHDOG_RESET()? XXX
+		 */
+		if (getenv_yesno("flashchecksum") == 1) {
+			printf("  CRC: %08X", crc32(0,
+				(const unsigned char *) CONFIG_SYS_FLASH_BASE,
+				flash_size));
+		}
+		putc('\n');
+# else	/* !CONFIG_SYS_FLASH_CHECKSUM */
+		print_size(flash_size, "\n");
+# endif /* CONFIG_SYS_FLASH_CHECKSUM */
+	} else {
+		puts(failed);
+		return -ENODEV;
+	}
+
+	return 0;
+}
+U_BOOT_LAZY_INIT(flash, arm_flash_init);
 #endif
 
 /*
@@ -520,20 +621,22 @@ static void display_fdt_model(const void *blob)
 void board_init_r(gd_t *id, ulong dest_addr)
 {
 	ulong malloc_start;
-#if !defined(CONFIG_SYS_NO_FLASH)
-	ulong flash_size;
-#endif
 
 	gd->flags |= GD_FLG_RELOC;	/* tell others: relocation done */
+#ifdef CONFIG_TRACE
+	trace_init(gd->trace_buff, CONFIG_TRACE_BUFFER_SIZE);
+#endif
 	bootstage_mark_name(BOOTSTAGE_ID_START_UBOOT_R, "board_init_r");
 
 	monitor_flash_len = _end_ofs;
 
 	/* Enable caches */
 	enable_caches();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "enable_caches");
 
 	debug("monitor flash len: %08lX\n", monitor_flash_len);
 	board_init();	/* Setup chipselects */
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "board_init");
 	/*
 	 * TODO: printing of the clock inforamtion of the board is now
 	 * implemented as part of bdinfo command. Currently only support for
@@ -544,6 +647,7 @@ void board_init_r(gd_t *id, ulong dest_addr)
 	set_cpu_clk_info(); /* Setup clock information */
 #endif
 	serial_initialize();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "serial_initialize");
 
 	debug("Now running in RAM - U-Boot at: %08lx\n", dest_addr);
 
@@ -558,41 +662,28 @@ void board_init_r(gd_t *id, ulong dest_addr)
 	malloc_start = dest_addr - TOTAL_MALLOC_LEN;
 	mem_malloc_init (malloc_start, TOTAL_MALLOC_LEN);
 
+	/* Step names may need the heap */
+	init_f_bootstage();
+
 #ifdef CONFIG_ARCH_EARLY_INIT_R
 	arch_early_init_r();
 #endif
 	power_init_board();
 
-#if !defined(CONFIG_SYS_NO_FLASH)
-	puts("Flash: ");
-
-	flash_size = flash_init();
-	if (flash_size > 0) {
-# ifdef CONFIG_SYS_FLASH_CHECKSUM
-		print_size(flash_size, "");
-		/*
-		 * Compute and print flash CRC if flashchecksum is set to 'y'
-		 *
-		 * NOTE: Maybe we should add some WATCHDOG_RESET()? XXX
-		 */
-		if (getenv_yesno("flashchecksum") == 1) {
-			printf("  CRC: %08X", crc32(0,
-				(const unsigned char *) CONFIG_SYS_FLASH_BASE,
-				flash_size));
-		}
-		putc('\n');
-# else	/* !CONFIG_SYS_FLASH_CHECKSUM */
-		print_size(flash_size, "\n");
-# endif /* CONFIG_SYS_FLASH_CHECKSUM */
-	} else {
-		puts(failed);
+	/*
+	 * With CONFIG_LAZY_INIT flash, PCI and the network are set up by
+	 * lazy_init() the first time they are used, if they are at all.
+	 */
+#if !defined(CONFIG_SYS_NO_FLASH) && !defined(CONFIG_LAZY_INIT)
+	if (arm_flash_init())
 		hang();
-	}
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "flash_init");
 #endif
 
 #if defined(CONFIG_CMD_NAND)
 	puts("NAND:  ");
 	nand_init();		/* go init the NAND */
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "nand_init");
 #endif
 
 #if defined(CONFIG_CMD_ONENAND)
@@ -602,6 +693,7 @@ void board_init_r(gd_t *id, ulong dest_addr)
 #ifdef CONFIG_GENERIC_MMC
 	puts("MMC:   ");
 	mmc_initialize(gd->bd);
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "mmc_initialize");
 #endif
 
 #ifdef CONFIG_HAS_DATAFLASH
@@ -614,12 +706,16 @@ void board_init_r(gd_t *id, ulong dest_addr)
 		env_relocate();
 	else
 		set_default_env(NULL);
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "env_relocate");
 
-#if defined(CONFIG_CMD_PCI) || defined(CONFIG_PCI)
+#if (defined(CONFIG_CMD_PCI) || defined(CONFIG_PCI)) && \
+	!defined(CONFIG_LAZY_INIT)
 	arm_pci_init();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "pci_init");
 #endif
 
 	stdio_init();	/* get the devices list going. */
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "stdio_init");
 
 	jumptable_init();
 
@@ -629,6 +725,7 @@ void board_init_r(gd_t *id, ulong dest_addr)
 #endif
 
 	console_init_r();	/* fully init console as a device */
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "console_init_r");
 
 #ifdef CONFIG_DISPLAY_BOARDINFO_LATE
 # ifdef CONFIG_OF_CONTROL
@@ -646,6 +743,7 @@ void board_init_r(gd_t *id, ulong dest_addr)
 #if defined(CONFIG_MISC_INIT_R)
 	/* miscellaneous platform dependent initialisations */
 	misc_init_r();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "misc_init_r");
 #endif
 
 	 /* set up exceptions */
@@ -658,18 +756,15 @@ void board_init_r(gd_t *id, ulong dest_addr)
 
 #ifdef CONFIG_BOARD_LATE_INIT
 	board_late_init();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "board_late_init");
 #endif
 
 #ifdef CONFIG_BITBANGMII
 	bb_miiphy_init();
 #endif
-#if defined(CONFIG_CMD_NET)
-	puts("Net:   ");
-	eth_initialize(gd->bd);
-#if defined(CONFIG_RESET_PHY_R)
-	debug("Reset Ethernet PHY\n");
-	reset_phy();
-#endif
+#if defined(CONFIG_CMD_NET) && !defined(CONFIG_LAZY_INIT)
+	arm_eth_init();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "eth_initialize");
 #endif
 
 #ifdef CONFIG_POST
@@ -79,16 +79,21 @@ static void announce_and_cleanup(int fake)
 		"(fake run for tracing)" : "");
 	bootstage_mark_name(BOOTSTAGE_ID_BOOTM_HANDOFF, "start_kernel");
 #ifdef CONFIG_BOOTSTAGE_FDT
-	if (flag == BOOTM_STATE_OS_FAKE_GO)
-		bootstage_fdt_add_report();
+	bootstage_fdt_add_report();
 #endif
 #ifdef CONFIG_BOOTSTAGE_REPORT
 	bootstage_report();
 #endif
+#ifdef CONFIG_BOOTSTAGE_STASH
+	/* for kernels booted with ATAGs, which have no device tree to read */
+	bootstage_stash((void *)CONFIG_BOOTSTAGE_STASH,
+			CONFIG_BOOTSTAGE_STASH_SIZE);
+#endif
 
 #ifdef CONFIG_USB_DEVICE
 	udc_disconnect();
 #endif
+	serial_flush();
 	cleanup_before_linux();
 }
 
@@ -20,7 +20,9 @@
  */
 
 #include <common.h>
+#include <errno.h>
 #include <os.h>
+#include <profile.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -42,6 +44,25 @@ unsigned long __attribute__((no_instrument_function)) timer_get_us(void)
 	return os_get_nsec() / 1000;
 }
 
+#ifdef CONFIG_PROFILE
+/* The host can't tell us the return address, so that is left out */
+static void __attribute__((no_instrument_function))
+		sandbox_profile_tick(unsigned long pc)
+{
+	profile_sample(pc, 0);
+}
+
+int profile_timer_start(unsigned int hz)
+{
+	return os_profile_timer(hz, sandbox_profile_tick) ? -EIO : 0;
+}
+
+void profile_timer_stop(void)
+{
+	os_profile_timer(0, NULL);
+}
+#endif
+
 int do_bootm_linux(int flag, int argc, char *argv[], bootm_headers_t *images)
 {
 	return -1;
@@ -19,15 +19,19 @@
  * MA 02111-1307 USA
  */
 
+#define _GNU_SOURCE		/* for the registers in ucontext_t */
+
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <termios.h>
 #include <time.h>
+#include <ucontext.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -171,6 +175,60 @@ u64 __attribute__((no_instrument_function)) os_get_nsec(void)
 #endif
 }
 
+static void (*profile_func)(unsigned long pc);
+
+static void __attribute__((no_instrument_function))
+		os_profile_signal(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = context;
+	unsigned long pc = 0;
+
+#if defined(__x86_64__)
+	pc = uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+	pc = uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+	pc = uc->uc_mcontext.pc;
+#elif defined(__arm__)
+	pc = uc->uc_mcontext.arm_pc;
+#endif
+	profile_func(pc);
+}
+
+int os_profile_timer(unsigned int hz, void (*func)(unsigned long pc))
+{
+	unsigned long usec = 0;
+	struct itimerval timer;
+	struct sigaction act;
+
+	memset(&act, '\0', sizeof(act));
+	if (hz) {
+		usec = hz < 1000000 ? 1000000 / hz : 1;
+		act.sa_sigaction = os_profile_signal;
+		act.sa_flags = SA_SIGINFO | SA_RESTART;
+		profile_func = func;
+	} else {
+		act.sa_handler = SIG_IGN;
+	}
+	timer.it_interval.tv_sec = usec / 1000000;
+	timer.it_interval.tv_usec = usec % 1000000;
+	timer.it_value = timer.it_interval;
+
+	/*
+	 * ITIMER_PROF counts the time we run, not the time we sleep. A
+	 * SIGPROF with no handler kills us, so it is caught before the timer
+	 * starts and only ignored once it has stopped.
+	 */
+	if (hz && sigaction(SIGPROF, &act, NULL))
+		return -1;
+	if (setitimer(ITIMER_PROF, &timer, NULL))
+		return -1;
+	if (!hz && sigaction(SIGPROF, &act, NULL))
+		return -1;
+
+	return 0;
+}
+
 static char *short_opts;
 static struct option *long_opts;
 
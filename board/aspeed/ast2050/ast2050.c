@@ -14,7 +14,16 @@
 #include <common.h>
 #include <command.h>
 #include <pci.h>
+#include <profile.h>
+#include <asm/io.h>
+#include <asm/arch/irq.h>
 #include "hwreg.h"
+#include "mic.h"
+#include "sdram.h"
+
+#ifdef CONFIG_FLASH_SPI
+extern void flash_spi_setup (void);
+#endif
 
 int board_init (void)
 {
@@ -38,6 +47,9 @@ int board_init (void)
 # else
     *((volatile ulong*) 0x16000000) |= 0x00001ff1;	/* enable Flash Write */
 # endif
+#endif
+#ifdef CONFIG_FLASH_SPI
+    flash_spi_setup();				/* read clock, before any probe */
 #endif
 
     /* SCU */
@@ -113,9 +125,23 @@ int board_init (void)
 int dram_init (void)
 {
     DECLARE_GLOBAL_DATA_PTR;
+    const struct ast_sdram_info *info = ast_sdram_info();
+    long size = PHYS_SDRAM_1_SIZE;
+
+    if (info)
+	size = ast_sdram_geometries[info->geometry].size;
+    size = get_ram_size((void *)PHYS_SDRAM_1, size);
+
+    /*
+     * The VGA frame buffer sits at the top of the parts, and the board
+     * may wire up less than they hold
+     */
+    size -= ast_sdram_vga_size();
+    if (size > PHYS_SDRAM_1_SIZE)
+	size = PHYS_SDRAM_1_SIZE;
 
     /* dram_init must store complete ramsize in gd->ram_size */
-    gd->ram_size = get_ram_size((void *)PHYS_SDRAM_1, PHYS_SDRAM_1_SIZE);
+    gd->ram_size = size;
 
     return 0;
 }
@@ -168,6 +194,7 @@ int misc_init_r(void)
     else if (chip_id == 0) {
 	printf("AST2050/AST2150 series chip\n");
     }
+    ast_sdram_report();
 
 #ifdef CONFIG_AST1070
 	puts ("C/C:   ");
@@ -175,7 +202,7 @@ int misc_init_r(void)
 	printf("AST1070 ID [%08x] \n", revision);
 #endif
 
-#ifdef	CONFIG_PCI
+#if defined(CONFIG_PCI) && !defined(CONFIG_LAZY_INIT)
     pci_init ();
 #endif
 
@@ -188,6 +215,20 @@ int misc_init_r(void)
 return 0;
 }
 
+/* Nothing U-Boot started may keep running, or interrupting, under the OS */
+void arch_preboot_os(void)
+{
+#ifdef CONFIG_ASPEED_MIC
+    mic_preboot_os();
+#endif
+#ifdef CONFIG_PROFILE
+    profile_stop();					/* timer2 */
+#endif
+#ifdef CONFIG_USE_IRQ
+    writel(~0UL, AST_VIC_DISABLE);
+#endif
+}
+
 #ifdef	CONFIG_PCI
 static struct pci_controller hose;
 
@@ -0,0 +1,63 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _AST2D_H_
+#define _AST2D_H_
+
+/*
+ * 2D engine, driven one command at a time through its MMIO registers
+ * (the same layout the host sees at offset 0x8000 of the VGA MMIO BAR).
+ */
+#define AST2D_BASE			0x1E760000
+
+#define AST2D_SRC_BASE			(AST2D_BASE + 0x00)
+#define AST2D_SRC_PITCH			(AST2D_BASE + 0x04)
+#define AST2D_DST_BASE			(AST2D_BASE + 0x08)
+#define AST2D_DST_PITCH			(AST2D_BASE + 0x0C)
+#define AST2D_DST_XY			(AST2D_BASE + 0x10)
+#define AST2D_SRC_XY			(AST2D_BASE + 0x14)
+#define AST2D_RECT_XY			(AST2D_BASE + 0x18)
+#define AST2D_FG			(AST2D_BASE + 0x1C)
+#define AST2D_BG			(AST2D_BASE + 0x20)
+#define AST2D_CMD			(AST2D_BASE + 0x3C)
+#define AST2D_CMDQ_SET			(AST2D_BASE + 0x44)
+#define AST2D_STATUS			(AST2D_BASE + 0x4C)
+
+/* AST2D_*_PITCH: pitch in bytes in the top half */
+#define AST2D_PITCH_SHIFT		16
+#define AST2D_PITCH_MASK		0x1FFF
+#define AST2D_DST_HEIGHT_MASK		0x7FF
+
+/* AST2D_*_XY, AST2D_RECT_XY: x (or width) in the top half */
+#define AST2D_X_SHIFT			16
+#define AST2D_XY_MASK			0xFFF
+
+/* AST2D_CMDQ_SET */
+#define AST2D_CMDQ_MMIO			0xF2000000	/* no command queue */
+
+/* AST2D_STATUS */
+#define AST2D_STATUS_BUSY		0x80000000
+
+/* AST2D_CMD */
+#define AST2D_CMD_BITBLT		0x00000000
+#define AST2D_CMD_COLOR_16		0x00000010
+#define AST2D_CMD_COLOR_32		0x00000020
+#define AST2D_CMD_ROP_SHIFT		8
+#define AST2D_CMD_PAT_FGCOLOR		0x00000000
+#define AST2D_CMD_Y_DEC			0x00100000
+#define AST2D_CMD_X_DEC			0x00200000
+
+/* Raster operations */
+#define AST2D_ROP_SRCCOPY		0xCC
+#define AST2D_ROP_PATCOPY		0xF0
+
+#endif /* _AST2D_H_ */
@@ -0,0 +1,342 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * DRAM throughput and latency, from the CPU and from the controller's
+ * test engine, plus a sweep of the arbitration registers with both
+ * masters hitting DRAM at once.
+ */
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <asm/io.h>
+#include "hwreg.h"
+#include "sdram.h"
+
+#ifdef CONFIG_CMD_DRAMPERF
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define PERF_DEFAULT_LEN	(4 << 20)
+#define PERF_MIN_LEN		(64 << 10)
+
+/* Each CPU figure is averaged over at least this long (us) */
+#define PERF_MIN_US		200000
+
+#define PERF_CHASE_STEPS	(1 << 18)
+#define PERF_NODE_WORDS		8	/* one cache line per chase node */
+
+/* The engine needs well under a second for any window that fits */
+#define PERF_ENGINE_TIMEOUT	1000
+
+/* Grant lengths tried by "sweep", one nibble per master */
+static const u32 perf_grants[] = {
+	0x00000000, 0x11111111, 0x22222222, 0x44444444, 0x88888888,
+	0xFFFFFFFF,
+};
+
+static volatile u32 perf_sink;
+
+static void perf_read(void *buf, ulong len)
+{
+	const u32 *p = buf, *end = buf + len;
+	u32 sum = 0;
+
+	while (p < end) {
+		sum += p[0] + p[1] + p[2] + p[3] + p[4] + p[5] + p[6] + p[7];
+		p += 8;
+	}
+	perf_sink = sum;
+}
+
+static void perf_write(void *buf, ulong len)
+{
+	memset(buf, 0x5a, len);
+}
+
+static void perf_copy(void *buf, ulong len)
+{
+	memcpy(buf, buf + len / 2, len / 2);
+}
+
+/* MB/s of fn over buf, counting bytes_per_run each time it is called */
+static ulong perf_rate(void (*fn)(void *, ulong), void *buf, ulong len,
+		       ulong bytes_per_run)
+{
+	ulong start = timer_get_us();
+	ulong us, runs = 0;
+
+	do {
+		fn(buf, len);
+		runs++;
+		us = timer_get_us() - start;
+	} while (us < PERF_MIN_US);
+
+	return runs * bytes_per_run / us;
+}
+
+/*
+ * Link one node per cache line into a single random cycle, so that every
+ * load depends on the one before and lands on a line of its own.
+ */
+static u32 *perf_chase_setup(void *buf, ulong len)
+{
+	u32 *node = buf;
+	ulong n = len / (PERF_NODE_WORDS * 4);
+	ulong i, j;
+	u32 seed = 0x2545f491, tmp;
+
+	for (i = 0; i < n; i++)
+		node[i * PERF_NODE_WORDS] = i;
+	for (i = n - 1; i > 0; i--) {
+		seed = seed * 1664525 + 1013904223;
+		j = seed % (i + 1);
+		tmp = node[i * PERF_NODE_WORDS];
+		node[i * PERF_NODE_WORDS] = node[j * PERF_NODE_WORDS];
+		node[j * PERF_NODE_WORDS] = tmp;
+	}
+	for (i = 0; i < n; i++) {
+		j = node[i * PERF_NODE_WORDS];
+		tmp = node[((i + 1) % n) * PERF_NODE_WORDS];
+		node[j * PERF_NODE_WORDS + 1] =
+			(u32)&node[tmp * PERF_NODE_WORDS + 1];
+	}
+	flush_dcache_range((ulong)buf, (ulong)buf + len);
+
+	return &node[node[0] * PERF_NODE_WORDS + 1];
+}
+
+/* ns per dependent load */
+static ulong perf_latency(void *buf, ulong len)
+{
+	u32 *p = perf_chase_setup(buf, len);
+	ulong start, us;
+	int i;
+
+	start = timer_get_us();
+	for (i = 0; i < PERF_CHASE_STEPS; i++)
+		p = (u32 *)*p;
+	us = timer_get_us() - start;
+	perf_sink = (u32)p;
+
+	return us * 1000 / PERF_CHASE_STEPS;
+}
+
+static void perf_cpu(const char *what, void *buf, ulong len)
+{
+	printf("CPU %-9s read %4lu MB/s  write %4lu MB/s  copy %4lu MB/s  "
+	       "latency %4lu ns\n", what,
+	       perf_rate(perf_read, buf, len, len),
+	       perf_rate(perf_write, buf, len, len),
+	       perf_rate(perf_copy, buf, len, len / 2),
+	       perf_latency(buf, len));
+}
+
+static int perf_engine_wait(u32 *fail)
+{
+	ulong start = get_timer(0);
+
+	while (!ast_sdram_engine_poll(fail)) {
+		if (get_timer(start) > PERF_ENGINE_TIMEOUT) {
+			ast_sdram_engine_stop();
+			puts("DRAM test engine timed out\n");
+			return -ETIMEDOUT;
+		}
+	}
+	if (*fail) {
+		printf("DRAM test engine failed, DQ %08x\n", *fail);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* MB/s of one engine pass; it writes and reads back every byte */
+static long perf_engine(ulong off, ulong len, u32 mode)
+{
+	ulong start = timer_get_us();
+	ulong us;
+	u32 fail;
+
+	ast_sdram_engine_start(AST_SDRAM_TEST_WINDOW(off, len), 0x5a5a5a5a,
+			       mode);
+	if (perf_engine_wait(&fail))
+		return -1;
+	us = timer_get_us() - start;
+
+	return us ? 2 * len / us : 0;
+}
+
+static void perf_arb_show(void)
+{
+	printf("MCR3C %08x  MCR40 %08x  MCR44 %08x\n",
+	       readl(SDRAM_PRIORITY_GROUP_SET_REG),
+	       readl(SDRAM_MAX_GRANT_LENGTH_REG1),
+	       readl(SDRAM_MAX_GRANT_LENGTH_REG2));
+}
+
+static void perf_arb_set(u32 prio, u32 grant1, u32 grant2)
+{
+	writel(prio, SDRAM_PRIORITY_GROUP_SET_REG);
+	writel(grant1, SDRAM_MAX_GRANT_LENGTH_REG1);
+	writel(grant2, SDRAM_MAX_GRANT_LENGTH_REG2);
+}
+
+/*
+ * The engine runs over the top half of the buffer while the CPU copies
+ * within the bottom half, so the figures show how the arbiter splits DRAM
+ * between the two.
+ */
+static int perf_sweep(void *buf, ulong len, int nprio, char * const prio[])
+{
+	ulong off = (ulong)buf - PHYS_SDRAM_1 + len / 2;
+	u32 saved[3];
+	ulong start, us, runs;
+	u32 p, fail;
+	int i, g, done, ret = 0;
+
+	saved[0] = readl(SDRAM_PRIORITY_GROUP_SET_REG);
+	saved[1] = readl(SDRAM_MAX_GRANT_LENGTH_REG1);
+	saved[2] = readl(SDRAM_MAX_GRANT_LENGTH_REG2);
+
+	puts("MCR3C     grant      CPU copy   engine\n");
+	for (i = 0; i < (nprio ? nprio : 1) && !ret; i++) {
+		p = nprio ? simple_strtoul(prio[i], NULL, 16) : saved[0];
+		for (g = 0; g < ARRAY_SIZE(perf_grants); g++) {
+			perf_arb_set(p, perf_grants[g], perf_grants[g]);
+
+			runs = 0;
+			start = timer_get_us();
+			ast_sdram_engine_start(
+				AST_SDRAM_TEST_WINDOW(off, len / 2),
+				0x5a5a5a5a, AST_SDRAM_TEST_BURST);
+			do {
+				perf_copy(buf, len / 2);
+				runs++;
+				done = ast_sdram_engine_poll(&fail);
+				us = timer_get_us() - start;
+			} while (!done && us < PERF_ENGINE_TIMEOUT * 1000);
+			if (!done) {
+				ast_sdram_engine_stop();
+				puts("DRAM test engine timed out\n");
+				ret = -ETIMEDOUT;
+				break;
+			}
+			if (fail) {
+				printf("DRAM test engine failed, DQ %08x\n",
+				       fail);
+				ret = -EIO;
+				break;
+			}
+
+			/* the engine figure includes the last CPU copy */
+			printf("%08x  %08x  %4lu MB/s  %4lu MB/s\n", p,
+			       perf_grants[g], runs * (len / 4) / us,
+			       len / us);
+			if (ctrlc()) {
+				ret = -EINTR;
+				break;
+			}
+		}
+	}
+
+	perf_arb_set(saved[0], saved[1], saved[2]);
+
+	return ret;
+}
+
+static int do_dramperf(cmd_tbl_t *cmdtp, int flag, int argc,
+		       char * const argv[])
+{
+	ulong addr = load_addr, len = PERF_DEFAULT_LEN;
+	void *buf;
+	long burst, single;
+	int sweep = 0, ret = 0;
+
+	if (argc > 1 && !strcmp(argv[1], "arb")) {
+		writel(AST_SDRAM_UNLOCK_KEY, SDRAM_PROTECTION_KEY_REG);
+		if (argc == 5)
+			perf_arb_set(simple_strtoul(argv[2], NULL, 16),
+				     simple_strtoul(argv[3], NULL, 16),
+				     simple_strtoul(argv[4], NULL, 16));
+		else if (argc != 2)
+			ret = CMD_RET_USAGE;
+		if (!ret)
+			perf_arb_show();
+		writel(0, SDRAM_PROTECTION_KEY_REG);
+		return ret;
+	}
+	if (argc > 1 && !strcmp(argv[1], "sweep")) {
+		sweep = 1;
+		argc--;
+		argv++;
+	}
+	if (!sweep && argc > 1)
+		addr = simple_strtoul(argv[1], NULL, 16);
+	if (!sweep && argc > 2)
+		len = simple_strtoul(argv[2], NULL, 16);
+	if (!sweep && argc > 3)
+		return CMD_RET_USAGE;
+
+	if (len < PERF_MIN_LEN || (len & (len - 1)) || (addr & (len - 1)) ||
+	    addr < PHYS_SDRAM_1 || addr + len > PHYS_SDRAM_1 + gd->ram_size) {
+		printf("need a power-of-two length of at least %u, aligned "
+		       "to itself, in DRAM\n", PERF_MIN_LEN);
+		return CMD_RET_FAILURE;
+	}
+	buf = (void *)addr;
+
+	writel(AST_SDRAM_UNLOCK_KEY, SDRAM_PROTECTION_KEY_REG);
+	if (sweep) {
+		ret = perf_sweep(buf, len, argc - 1, argv + 1);
+		goto out;
+	}
+
+	printf("%lu KiB at %08lx\n", len >> 10, addr);
+	if (dcache_status()) {
+		perf_cpu("cached", buf, len);
+		dcache_disable();
+		perf_cpu("uncached", buf, len);
+		dcache_enable();
+	} else {
+		perf_cpu("uncached", buf, len);
+	}
+
+	burst = perf_engine(addr - PHYS_SDRAM_1, len, AST_SDRAM_TEST_BURST);
+	single = perf_engine(addr - PHYS_SDRAM_1, len, AST_SDRAM_TEST_SINGLE);
+	if (burst < 0 || single < 0)
+		ret = -EIO;
+	else
+		printf("engine    burst %4ld MB/s  single %4ld MB/s\n", burst,
+		       single);
+	perf_arb_show();
+
+out:
+	writel(0, SDRAM_PROTECTION_KEY_REG);
+
+	return ret ? CMD_RET_FAILURE : 0;
+}
+
+U_BOOT_CMD(
+	dramperf,	6,	0,	do_dramperf,
+	"DRAM bandwidth and latency",
+	"[addr [len]]\n"
+	"    - CPU and test engine figures over len bytes at addr\n"
+	"dramperf arb [mcr3c mcr40 mcr44]\n"
+	"    - show or set the DRAM arbitration registers\n"
+	"dramperf sweep [mcr3c ...]\n"
+	"    - CPU copy and engine throughput with both running, for each\n"
+	"      grant length and each given priority setting"
+);
+
+#endif /* CONFIG_CMD_DRAMPERF */
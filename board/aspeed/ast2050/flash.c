@@ -386,7 +386,7 @@ unsigned long flash_init (void)
 #ifdef CONFIG_ENV_ADDR_REDUND
 	flash_protect (FLAG_PROTECT_SET,
 		       CONFIG_ENV_ADDR_REDUND,
-		       CONFIG_ENV_ADDR_REDUND + CONFIG_ENV_SIZE_REDUND - 1,
+		       CONFIG_ENV_ADDR_REDUND + CONFIG_ENV_SECT_SIZE - 1,
 		       flash_get_info(CONFIG_ENV_ADDR_REDUND));
 #endif
 	return (size);
@@ -1648,6 +1648,10 @@ void * memmove_dma(void * dest,const void *src,size_t count)
 	
 	/* clear status */
 	*(ulong *) (STCBaseAddress + REG_FLASH_INTERRUPT_STATUS) |= FLASH_STATUS_DMA_CLEAR;
+
+	/* drop stale cached lines over the copy */
+	invalidate_dcache_range((ulong)dest & ~(ARCH_DMA_MINALIGN - 1),
+				ALIGN((ulong)dest + count_align, ARCH_DMA_MINALIGN));
 }	
 #endif
 #endif /* CFG_FLASH_CFI */
@@ -114,6 +114,9 @@ flash_info_t flash_info[CONFIG_SYS_MAX_FLASH_BANKS];		/* FLASH chips info */
 
 #define BufferSize		256
 
+/* Read clock (MHz) that every supported part takes, before the probe */
+#define SPI_SAFE_READ_CLK	40
+
 /*-----------------------------------------------------------------------
  * Functions
  */
@@ -312,6 +315,89 @@ static void write_status_register (flash_info_t * info, uchar data)
 
 }
 
+/*
+ * SPI controller clock in MHz, from the CPU clock strap
+ */
+static ulong spi_src_clk (void)
+{
+	ulong reg, cpuclk = 266;
+
+	reg = *((volatile ulong*) 0x1e6e2070);
+	switch (reg & 0xe00)
+	{
+	case 0x000:
+		 cpuclk = 266;
+		 break;
+	case 0x200:
+		 cpuclk = 233;
+		 break;
+	case 0x400:
+		 cpuclk = 200;
+		 break;
+	case 0x600:
+		 cpuclk = 166;
+		 break;
+	case 0x800:
+		 cpuclk = 133;
+		 break;
+	case 0xA00:
+		 cpuclk = 100;
+		 break;
+	case 0xC00:
+		 cpuclk = 300;
+		 break;
+	case 0xE00:
+		 cpuclk = 24;
+		 break;
+	}
+	switch (reg & 0x3000)
+	{
+	case 0x1000:
+		 cpuclk /= 2;
+		 break;
+	case 0x2000:
+		 cpuclk /= 4;
+		 break;
+	case 0x3000:
+		 cpuclk /= 3;
+		 break;
+	}
+
+	return cpuclk;
+}
+
+/*
+ * tCK code for the fastest SPI clock that is no more than maxclk MHz
+ */
+static int spi_tck (ulong cpuclk, ulong maxclk)
+{
+	ulong div = 2;
+	int tck = 7;
+
+	while ( (cpuclk/div) > maxclk )
+	{
+	    tck--;
+	    div +=2;
+	}
+
+	return tck;
+}
+
+/*
+ * Fast read at a clock every part in the table takes. flash_get_size()
+ * replaces this with the part's own settings, but with CONFIG_LAZY_INIT
+ * that may never happen, and reads through the flash window would stay
+ * at the power-on clock.
+ */
+void flash_spi_setup (void)
+{
+	ulong ulCtrlData;
+
+	ulCtrlData  = (0x0b0000) | (spi_tck(spi_src_clk(), SPI_SAFE_READ_CLK) << 8) | (1 << 6);
+	ulCtrlData |= CE_HIGH | FASTREAD;
+	*(ulong *) (STCBaseAddress + SPICtrlRegOffset) = ulCtrlData;
+}
+
 /*
  *
  */
@@ -323,11 +409,10 @@ static ulong flash_get_size (ulong base, int banknum)
 	int erase_region_size;
 	ulong ulCtrlData;
 	int usID;
-	ulong cpuclk, div, reg;
+	ulong cpuclk;
 	ulong WriteClk, EraseClk, ReadClk;
 
 	info->start[0] = base;
-	cpuclk = 266;
 	erase_region_size  = 0x10000;
 	WriteClk = 40;
 	EraseClk = 20;
@@ -442,68 +527,11 @@ static ulong flash_get_size (ulong base, int banknum)
 	}
 
 	/* set SPI flash extended info */
-	reg = *((volatile ulong*) 0x1e6e2070);
-	switch (reg & 0xe00)
-	{
-	case 0x000:
-		 cpuclk = 266;
-		 break;
-	case 0x200:
-		 cpuclk = 233;
-		 break;
-	case 0x400:
-		 cpuclk = 200;
-		 break;
-	case 0x600:
-		 cpuclk = 166;
-		 break;
-	case 0x800:
-		 cpuclk = 133;
-		 break;
-	case 0xA00:
-		 cpuclk = 100;
-		 break;
-	case 0xC00:
-		 cpuclk = 300;
-		 break;
-	case 0xE00:	
-		 cpuclk = 24;
-		 break;
-	}	
-	switch (reg & 0x3000)
-	{
-	case 0x1000:
-		 cpuclk /= 2;
-		 break;
-	case 0x2000:
-		 cpuclk /= 4;
-		 break;
-	case 0x3000:	
-		 cpuclk /= 3;
-		 break;
-	}	
-	div = 2;
-	info->tCK_Write = 7;
-	while ( (cpuclk/div) > WriteClk )
-	{
-	    info->tCK_Write--;	
-	    div +=2;	
-	}
-	div = 2;
-	info->tCK_Erase = 7;
-	while ( (cpuclk/div) > EraseClk )
-	{
-	    info->tCK_Erase--;	
-	    div +=2;	
-	}
-	div = 2;
-	info->tCK_Read = 7;
-	while ( (cpuclk/div) > ReadClk )
-	{
-	    info->tCK_Read--;	
-	    div +=2;	
-	}
-	
+	cpuclk = spi_src_clk();
+	info->tCK_Write = spi_tck(cpuclk, WriteClk);
+	info->tCK_Erase = spi_tck(cpuclk, EraseClk);
+	info->tCK_Read = spi_tck(cpuclk, ReadClk);
+
 	/* unprotect flash */	
 	write_status_register(info, 0);
 
@@ -660,7 +688,7 @@ unsigned long flash_init (void)
 #ifdef CONFIG_ENV_ADDR_REDUND
 	flash_protect (FLAG_PROTECT_SET,
 		       CONFIG_ENV_ADDR_REDUND,
-		       CONFIG_ENV_ADDR_REDUND + CONFIG_ENV_SIZE_REDUND - 1,
+		       CONFIG_ENV_ADDR_REDUND + CONFIG_ENV_SECT_SIZE - 1,
 		       flash_get_info(CONFIG_ENV_ADDR_REDUND));
 #endif
 	return (size);
@@ -114,6 +114,9 @@
 #define TIMER3_FIRST_MATCH_REG          (AST_TIMER_BASE + 0x28)
 #define TIMER3_SEC_MATCH_REG            (AST_TIMER_BASE + 0x2C)
 
+#define TIMER4_COUNT_REG                (AST_TIMER_BASE + 0x40)
+#define TIMER4_RELOAD_REG               (AST_TIMER_BASE + 0x44)
+
 #define TIMER_CONTROL_REG               (AST_TIMER_BASE + 0x30)
 
 /* --------------------------------------------------------------------
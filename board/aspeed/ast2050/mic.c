@@ -0,0 +1,289 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Memory Integrity Check engine as a DRAM scrubber
+ *
+ * Images loaded for bootm can be handed to the MIC engine, which keeps
+ * checksumming their pages in the background and flags any page that
+ * changes, e.g. from a stray DMA. Checking them before boot is then a
+ * register read instead of a CRC over megabytes. The engine is always
+ * stopped before the OS starts, since its buffers are ordinary DRAM.
+ */
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <malloc.h>
+#include <asm/io.h>
+#include "hwreg.h"
+#include "mictest.h"
+#include "mic.h"
+
+#ifdef CONFIG_ASPEED_MIC
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define MIC_PAGE_SHIFT		12
+#define MIC_PAGE_SIZE		(1 << MIC_PAGE_SHIFT)
+#define MIC_MAX_RANGES		8
+
+/* Every page is visited many times a second; this allows for a slow rate */
+#define MIC_VERIFY_TIMEOUT	5000
+
+#define SCU_RESET_MIC		0x00040000
+
+#ifndef CONFIG_ASPEED_MIC_RATE
+#define CONFIG_ASPEED_MIC_RATE	DEFAULT_RATE
+#endif
+
+struct mic_range {
+	ulong start;		/* page index from the start of DRAM */
+	ulong pages;
+};
+
+static struct mic_range mic_ranges[MIC_MAX_RANGES];
+static int mic_nranges;
+static u8 *mic_ctrl;		/* 2 bits per page */
+static u32 *mic_sum;		/* one checksum per page, 0 until taken */
+static ulong mic_pages;		/* pages of DRAM the buffers cover */
+
+static void mic_engine_stop(void)
+{
+	writel(MIC_RESET_MIC, MIC_BASE + MIC_ENGINECTRL_REG);
+}
+
+static void mic_engine_start(void)
+{
+	ulong last = 0;
+	int i;
+
+	for (i = 0; i < mic_nranges; i++)
+		last = max(last, mic_ranges[i].start + mic_ranges[i].pages - 1);
+
+	flush_dcache_range((ulong)mic_ctrl,
+			   (ulong)mic_ctrl + ALIGN(mic_pages / 4,
+						   ARCH_DMA_MINALIGN));
+	flush_dcache_range((ulong)mic_sum,
+			   (ulong)mic_sum + ALIGN(mic_pages * 4,
+						  ARCH_DMA_MINALIGN));
+
+	writel((ulong)mic_ctrl, MIC_BASE + MIC_CTRLBUFF_REG);
+	writel((ulong)mic_sum, MIC_BASE + MIC_CHKSUMBUF_REG);
+	writel(CONFIG_ASPEED_MIC_RATE, MIC_BASE + MIC_RATECTRL_REG);
+	writel(MIC_ENABLE_MIC | ((last << MIC_PAGE_SHIFT) & MIC_MAXPAGE_MASK),
+	       MIC_BASE + MIC_ENGINECTRL_REG);
+}
+
+static int mic_setup(void)
+{
+	if (mic_ctrl)
+		return 0;
+
+	mic_pages = ALIGN(gd->ram_size >> MIC_PAGE_SHIFT, 4);
+	mic_ctrl = memalign(ARCH_DMA_MINALIGN,
+			    ALIGN(mic_pages / 4, ARCH_DMA_MINALIGN));
+	mic_sum = memalign(ARCH_DMA_MINALIGN,
+			   ALIGN(mic_pages * 4, ARCH_DMA_MINALIGN));
+	if (!mic_ctrl || !mic_sum) {
+		free(mic_ctrl);
+		free(mic_sum);
+		mic_ctrl = NULL;
+		mic_sum = NULL;
+		return -ENOMEM;
+	}
+	memset(mic_ctrl, MIC_CTRL_SKIP, mic_pages / 4);
+
+	writel(0x1688A8A8, SCU_KEY_CONTROL_REG);
+	writel(readl(SCU_SYS_RESET_REG) & ~SCU_RESET_MIC, SCU_SYS_RESET_REG);
+
+	return 0;
+}
+
+int mic_protect(ulong addr, ulong len)
+{
+	ulong start, end, page;
+	int ret;
+
+	if (!len || addr < PHYS_SDRAM_1 ||
+	    addr + len > PHYS_SDRAM_1 + gd->ram_size || addr + len < addr)
+		return -EINVAL;
+	if (mic_nranges == MIC_MAX_RANGES)
+		return -ENOSPC;
+	ret = mic_setup();
+	if (ret)
+		return ret;
+
+	start = (addr - PHYS_SDRAM_1) >> MIC_PAGE_SHIFT;
+	end = (addr - PHYS_SDRAM_1 + len - 1) >> MIC_PAGE_SHIFT;
+
+	mic_engine_stop();
+	for (page = start; page <= end; page++) {
+		mic_ctrl[page / 4] |= MIC_CTRL_CHK3 << ((page % 4) * 2);
+		mic_sum[page] = DEFAULT_CHKSUM;
+	}
+	mic_ranges[mic_nranges].start = start;
+	mic_ranges[mic_nranges].pages = end - start + 1;
+	mic_nranges++;
+	mic_engine_start();
+
+	return 0;
+}
+
+static int mic_pending(void)
+{
+	int i;
+	ulong page;
+
+	invalidate_dcache_range((ulong)mic_sum,
+				(ulong)mic_sum + ALIGN(mic_pages * 4,
+						       ARCH_DMA_MINALIGN));
+	for (i = 0; i < mic_nranges; i++)
+		for (page = mic_ranges[i].start;
+		     page < mic_ranges[i].start + mic_ranges[i].pages; page++)
+			if (mic_sum[page] == DEFAULT_CHKSUM)
+				return 1;
+
+	return 0;
+}
+
+int mic_verify(ulong *bad)
+{
+	ulong start = get_timer(0);
+	u32 status;
+
+	if (!mic_nranges)
+		return -ENODEV;
+
+	while (mic_pending()) {
+		if (get_timer(start) > MIC_VERIFY_TIMEOUT)
+			return -ETIMEDOUT;
+		udelay(100);
+	}
+
+	status = readl(MIC_BASE + MIC_STATUS_REG);
+	if (!(status & MIC_PAGEERROR))
+		return 0;
+
+	if (bad)
+		*bad = PHYS_SDRAM_1 +
+		       ((status & MIC_ERRPAGENO_MASK) << MIC_PAGE_SHIFT);
+
+	return -EIO;
+}
+
+void mic_stop(void)
+{
+	if (!mic_ctrl)
+		return;
+
+	mic_engine_stop();
+	memset(mic_ctrl, MIC_CTRL_SKIP, mic_pages / 4);
+	mic_nranges = 0;
+}
+
+static int mic_report(void)
+{
+	ulong bad;
+	int ret = mic_verify(&bad);
+
+	switch (ret) {
+	case 0:
+		puts("MIC:   watched pages unchanged\n");
+		break;
+	case -EIO:
+		printf("MIC:   page at %08lx changed since it was loaded\n",
+		       bad);
+		break;
+	case -ETIMEDOUT:
+		puts("MIC:   engine did not checksum every page\n");
+		break;
+	}
+
+	return ret;
+}
+
+/* Last chance to catch a corrupted image; the OS gets the buffers back */
+void mic_preboot_os(void)
+{
+	if (!mic_nranges)
+		return;
+
+	mic_report();
+	mic_stop();
+}
+
+static int do_mic(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	ulong addr, len;
+	int i, ret;
+
+	if (argc < 2) {
+		for (i = 0; i < mic_nranges; i++)
+			printf("%08lx - %08lx\n",
+			       PHYS_SDRAM_1 +
+			       (mic_ranges[i].start << MIC_PAGE_SHIFT),
+			       PHYS_SDRAM_1 +
+			       ((mic_ranges[i].start + mic_ranges[i].pages)
+				<< MIC_PAGE_SHIFT) - 1);
+		if (!mic_nranges)
+			puts("nothing watched\n");
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "protect")) {
+		if (argc == 4) {
+			addr = simple_strtoul(argv[2], NULL, 16);
+			len = simple_strtoul(argv[3], NULL, 16);
+		} else if (argc == 2) {
+			/* the file loaded last */
+			addr = getenv_ulong("fileaddr", 16, load_addr);
+			len = getenv_ulong("filesize", 16, 0);
+		} else {
+			return CMD_RET_USAGE;
+		}
+		ret = mic_protect(addr, len);
+		if (ret) {
+			printf("can't watch %08lx + %lx (%d)\n", addr, len, ret);
+			return CMD_RET_FAILURE;
+		}
+		return 0;
+	}
+	if (!strcmp(argv[1], "verify")) {
+		if (!mic_nranges) {
+			puts("nothing watched\n");
+			return CMD_RET_FAILURE;
+		}
+		return mic_report() ? CMD_RET_FAILURE : 0;
+	}
+	if (!strcmp(argv[1], "stop")) {
+		mic_stop();
+		return 0;
+	}
+
+	return CMD_RET_USAGE;
+}
+
+U_BOOT_CMD(
+	mic,	4,	0,	do_mic,
+	"DRAM integrity check of loaded images",
+	"\n"
+	"    - list the watched ranges\n"
+	"mic protect [addr len]\n"
+	"    - watch a range, by default the file loaded last\n"
+	"mic verify\n"
+	"    - check that no watched page has changed\n"
+	"mic stop\n"
+	"    - stop watching (done anyway before an OS is booted)"
+);
+
+#endif /* CONFIG_ASPEED_MIC */
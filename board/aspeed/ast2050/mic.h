@@ -0,0 +1,56 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _MIC_H_
+#define _MIC_H_
+
+/**
+ * Have the MIC engine watch a range of DRAM
+ *
+ * The range is widened to whole 4KB pages. The engine takes a checksum of
+ * each page on its first pass and compares against it on every pass after
+ * that, in the background, until mic_stop(). The data must not change
+ * while it is watched.
+ *
+ * @param addr	Start of the range
+ * @param len	Length in bytes
+ * @return 0 if ok, -EINVAL if the range is not in DRAM, -ENOMEM if the
+ * engine buffers could not be allocated
+ */
+int mic_protect(ulong addr, ulong len);
+
+/**
+ * Check the watched pages
+ *
+ * Waits for the engine to have taken a checksum of every watched page,
+ * then reads back its status.
+ *
+ * @param bad	If not NULL, receives the address of the first page that
+ *		changed
+ * @return 0 if nothing changed, -EIO if a page changed, -ENODEV if
+ * nothing is watched, -ETIMEDOUT if the engine did not get round to
+ * every page
+ */
+int mic_verify(ulong *bad);
+
+/**
+ * Stop the engine and forget all ranges
+ */
+void mic_stop(void);
+
+/**
+ * Report on the watched pages, if any, and stop the engine before an OS
+ * takes over the memory it uses
+ */
+void mic_preboot_os(void);
+
+#endif /* _MIC_H_ */
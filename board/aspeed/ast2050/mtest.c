@@ -0,0 +1,163 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * mtest pattern passes on the DRAM controller's test engine
+ *
+ * The range is cut into aligned power-of-two windows, each run through
+ * every data generator in burst and single mode, as dramtest does. Odd
+ * ends below the smallest window are left to the CPU.
+ */
+#include <common.h>
+#include <errno.h>
+#include <watchdog.h>
+#include <asm/io.h>
+#include <asm/arch/irq.h>
+#include "hwreg.h"
+#include "sdram.h"
+
+#ifdef CONFIG_CMD_MEMTEST
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define MTEST_MIN_WINDOW	(1 << 10)
+#define MTEST_MAX_WINDOW	(8 << 20)
+#define MTEST_GENERATORS	8
+#define MTEST_TIMEOUT		1000	/* ms per pass over one window */
+
+static ulong mtest_cpu(ulong start, ulong end, ulong pattern)
+{
+	vu_long *addr;
+	ulong errs = 0, val;
+
+	for (addr = (vu_long *)start; addr < (vu_long *)end; addr++)
+		*addr = pattern ^ (ulong)addr;
+	for (addr = (vu_long *)start; addr < (vu_long *)end; addr++) {
+		val = *addr;
+		if (val != (pattern ^ (ulong)addr)) {
+			printf("\nMem error @ 0x%08lx: found %08lx, expected "
+			       "%08lx\n", (ulong)addr, val,
+			       pattern ^ (ulong)addr);
+			errs++;
+		}
+	}
+
+	return errs;
+}
+
+/* Returns 1 if the window failed, 0 if not, -1 if the engine hung */
+static int mtest_window(ulong addr, ulong len, ulong pattern)
+{
+	static const u32 modes[] = {
+		AST_SDRAM_TEST_BURST, AST_SDRAM_TEST_SINGLE,
+	};
+	u32 window = AST_SDRAM_TEST_WINDOW(addr - PHYS_SDRAM_1, len);
+	ulong start;
+	u32 fail;
+	int m, gen;
+
+	for (m = 0; m < ARRAY_SIZE(modes); m++) {
+		for (gen = 0; gen < MTEST_GENERATORS; gen++) {
+			WATCHDOG_RESET();
+			ast_sdram_engine_start(window, pattern, modes[m] |
+				(gen << AST_SDRAM_TEST_DATAGEN_SHIFT));
+			start = get_timer(0);
+			while (!ast_sdram_engine_poll(&fail)) {
+				if (get_timer(start) > MTEST_TIMEOUT) {
+					ast_sdram_engine_stop();
+					printf("\nDRAM test engine hung at "
+					       "0x%08lx\n", addr);
+					return -1;
+				}
+			}
+			if (fail) {
+				printf("\nMem error in 0x%08lx..0x%08lx: "
+				       "DQ %08x (%s, generator %d)\n", addr,
+				       addr + len - 1, fail,
+				       m ? "single" : "burst", gen);
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int mem_test_hw(ulong start_addr, ulong end_addr, ulong pattern, ulong *errs)
+{
+	ulong addr, len, next;
+	int ret = 0;
+
+	if (start_addr < PHYS_SDRAM_1 || start_addr >= end_addr ||
+	    end_addr > PHYS_SDRAM_1 + gd->ram_size)
+		return -ENOSYS;
+
+	printf("\rPattern %08lX  DRAM test engine...", pattern);
+	writel(AST_SDRAM_UNLOCK_KEY, SDRAM_PROTECTION_KEY_REG);
+
+	*errs = 0;
+	for (addr = start_addr; addr < end_addr && !ret; addr = next) {
+		len = MTEST_MAX_WINDOW;
+		while (len >= MTEST_MIN_WINDOW &&
+		       (((addr - PHYS_SDRAM_1) & (len - 1)) ||
+			addr + len > end_addr))
+			len >>= 1;
+
+		if (len < MTEST_MIN_WINDOW) {
+			next = min(end_addr, ALIGN(addr + 1, MTEST_MIN_WINDOW));
+			*errs += mtest_cpu(addr, next, pattern);
+			continue;
+		}
+
+		next = addr + len;
+		ret = mtest_window(addr, len, pattern);
+		if (ret > 0) {
+			(*errs)++;
+			ret = 0;
+		}
+		if (ctrlc())
+			ret = -1;
+	}
+
+	writel(0, SDRAM_PROTECTION_KEY_REG);
+	/* the engine wrote behind the (write-through) D-cache */
+	invalidate_dcache_range(start_addr & ~(ARCH_DMA_MINALIGN - 1),
+				ALIGN(end_addr, ARCH_DMA_MINALIGN));
+
+	if (ret)
+		*errs = -1UL;
+
+	return 0;
+}
+
+/*
+ * Keep mtest off U-Boot's stack and everything relocation put above it,
+ * and off the vectors a build with interrupts copies to the start of
+ * DRAM, whether reached there or through address 0
+ */
+int mem_test_check(ulong start_addr, ulong end_addr)
+{
+#ifdef CONFIG_USE_IRQ
+	if (start_addr < AST_VECTORS_SIZE)
+		return -EBUSY;
+	if (start_addr < CONFIG_SYS_SDRAM_BASE + AST_VECTORS_SIZE &&
+	    end_addr > CONFIG_SYS_SDRAM_BASE)
+		return -EBUSY;
+#endif
+	if (end_addr > gd->start_addr_sp - CONFIG_STACKSIZE)
+		return -EBUSY;
+
+	return 0;
+}
+
+#endif /* CONFIG_CMD_MEMTEST */
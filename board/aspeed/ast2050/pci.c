@@ -72,14 +72,192 @@ static int pci_config_access (u8 access_type, u32 dev, u32 reg, u32 * data)
 	return (CHK_PCI_STATUS);
 }
 
+/*
+ * Config space shadow
+ *
+ * Every config access is a full dword cycle through the CSR window, so the
+ * standard header of each function is kept in a shadow once read. Byte and
+ * word reads, and the read half of a byte or word write, are then served
+ * from it. Writes always go to the device and drop the shadowed dword, as
+ * what reads back need not be what was written (BAR sizing, for one).
+ * The command/status dword and a bridge's secondary status are never
+ * shadowed, as the device changes them by itself.
+ *
+ * The first access to a function reads its vendor ID; a device number
+ * whose function 0 is not there is marked empty and answers all-ones
+ * from then on without a bus cycle.
+ */
+#define PCI_SHADOW_FUNCS	16
+#define PCI_SHADOW_DWORDS	16	/* the 64-byte standard header */
+#define PCI_SHADOW_BUSES	16
+
+struct pci_shadow {
+	u32 dev;		/* PCI_BDF() of the function */
+	u32 valid;		/* one bit per shadowed dword */
+	u32 cfg[PCI_SHADOW_DWORDS];
+};
+
+static struct pci_shadow pci_shadow[PCI_SHADOW_FUNCS];
+static int pci_shadow_used;
+static u32 pci_empty[PCI_SHADOW_BUSES];	/* one bit per device number */
+static ulong pci_cycles;		/* config cycles actually issued */
+
+static void pci_shadow_flush(void)
+{
+	memset(pci_shadow, 0, sizeof(pci_shadow));
+	memset(pci_empty, 0, sizeof(pci_empty));
+	pci_shadow_used = 0;
+	pci_cycles = 0;
+}
+
+static int pci_shadow_cacheable(u32 reg)
+{
+	return reg < PCI_SHADOW_DWORDS * 4 && reg != PCI_COMMAND &&
+	       reg != PCI_IO_BASE;	/* also a bridge's secondary status */
+}
+
+static int pci_dev_empty(u32 dev)
+{
+	u32 bus = PCI_BUS(dev);
+
+	return bus < PCI_SHADOW_BUSES &&
+	       (pci_empty[bus] & (1U << PCI_DEV(dev)));
+}
+
+static struct pci_shadow *pci_shadow_find(u32 dev)
+{
+	int i;
+
+	for (i = 0; i < pci_shadow_used; i++)
+		if (pci_shadow[i].dev == dev)
+			return &pci_shadow[i];
+
+	return NULL;
+}
+
+static int pci_hw_access(u8 access_type, u32 dev, u32 reg, u32 *data)
+{
+	pci_cycles++;
+	return pci_config_access(access_type, dev, reg, data);
+}
+
+/*
+ * First access to a function: read its IDs. Returns 0 if it is there,
+ * with the IDs in *id, or -1 if not.
+ */
+static int pci_shadow_probe(u32 dev, u32 *id)
+{
+	struct pci_shadow *sh;
+
+	if (pci_hw_access(PCI_CMD_READ, dev, PCI_VENDOR_ID, id) ||
+	    (*id & 0xffff) == 0xffff || (*id & 0xffff) == 0) {
+		if (!PCI_FUNC(dev) && PCI_BUS(dev) < PCI_SHADOW_BUSES)
+			pci_empty[PCI_BUS(dev)] |= 1U << PCI_DEV(dev);
+		return -1;
+	}
+
+	/* Once full, further functions just go uncached */
+	if (pci_shadow_used < PCI_SHADOW_FUNCS) {
+		sh = &pci_shadow[pci_shadow_used++];
+		sh->dev = dev;
+		sh->cfg[0] = *id;
+		sh->valid = 1;
+	}
+
+	return 0;
+}
+
+static int pci_shadow_read(u32 dev, u32 reg, u32 *data)
+{
+	struct pci_shadow *sh;
+	u32 idx = (reg & 0xfc) / 4;
+
+	reg &= 0xfc;
+	if (pci_dev_empty(dev)) {
+		*data = 0xffffffff;
+		return 0;
+	}
+
+	sh = pci_shadow_find(dev);
+	/* With the table full, an unknown function costs one direct access */
+	if (!sh && pci_shadow_used < PCI_SHADOW_FUNCS) {
+		if (pci_shadow_probe(dev, data)) {
+			*data = 0xffffffff;
+			return 0;
+		}
+		if (reg == PCI_VENDOR_ID)
+			return 0;
+		sh = pci_shadow_find(dev);
+	}
+
+	if (sh && pci_shadow_cacheable(reg) && (sh->valid & (1 << idx))) {
+		*data = sh->cfg[idx];
+		return 0;
+	}
+
+	if (pci_hw_access(PCI_CMD_READ, dev, reg, data))
+		return -1;
+
+	if (sh && pci_shadow_cacheable(reg)) {
+		sh->cfg[idx] = *data;
+		sh->valid |= 1 << idx;
+	}
+
+	return 0;
+}
+
+static int pci_shadow_write(u32 dev, u32 reg, u32 data)
+{
+	struct pci_shadow *sh;
+
+	reg &= 0xfc;
+	if (pci_dev_empty(dev))
+		return 0;
+
+	sh = pci_shadow_find(dev);
+	if (sh)
+		sh->valid &= ~(1 << (reg / 4));
+
+	return pci_hw_access(PCI_CMD_WRITE, dev, reg, &data) ? -1 : 0;
+}
+
+/*
+ * Merge a byte or word into its dword and write that back. The status
+ * bits are write-one-to-clear, so writing the command register, or a
+ * bridge's I/O base and limit, must not hand back the status read
+ * alongside.
+ */
+static int pci_shadow_write_part(u32 dev, u32 reg, u32 val, u32 mask)
+{
+	u32 shift = (reg & 3) << 3;
+	u32 data, hdr;
+
+	if (pci_shadow_read(dev, reg, &data))
+		return -1;
+
+	if ((reg & 0xfc) == PCI_COMMAND && reg < PCI_STATUS)
+		data &= 0x0000ffff;
+
+	if ((reg & 0xfc) == PCI_IO_BASE && reg < PCI_SEC_STATUS) {
+		if (pci_shadow_read(dev, PCI_HEADER_TYPE, &hdr))
+			return -1;
+		if (((hdr >> 16) & 0x7f) == PCI_HEADER_TYPE_BRIDGE)
+			data &= 0x0000ffff;
+	}
+
+	data = (data & ~(mask << shift)) | ((val & mask) << shift);
+
+	return pci_shadow_write(dev, reg, data);
+}
+
 static int aspeed_pci_read_config_byte (u32 hose, u32 dev, u32 reg, u8 * val)
 {
 	u32 data;
 
-	if (pci_config_access (PCI_CMD_READ, dev, reg, &data)) {
+	if (pci_shadow_read(dev, reg, &data)) {
 		*val = 0;
 		return -1;
-	}	
+	}
 
 	*val = (data >> ((reg & 3) << 3)) & 0xff;
 
@@ -94,10 +272,10 @@ static int aspeed_pci_read_config_word (u32 hose, u32 dev, u32 reg, u16 * val)
 	if (reg & 1)
 		return -1;
 
-	if (pci_config_access (PCI_CMD_READ, dev, reg, &data)) {
+	if (pci_shadow_read(dev, reg, &data)) {
 		*val = 0;
 		return -1;
-	} 		
+	}
 
 	*val = (data >> ((reg & 3) << 3)) & 0xffff;
 
@@ -113,10 +291,10 @@ static int aspeed_pci_read_config_dword (u32 hose, u32 dev, u32 reg,
 	if (reg & 3)
 		return -1;
 
-	if (pci_config_access (PCI_CMD_READ, dev, reg, &data))	{
+	if (pci_shadow_read(dev, reg, &data)) {
 		*val = 0;
 		return -1;
-	}		
+	}
 
 	*val = data;
 
@@ -125,54 +303,25 @@ static int aspeed_pci_read_config_dword (u32 hose, u32 dev, u32 reg,
 
 static int aspeed_pci_write_config_byte (u32 hose, u32 dev, u32 reg, u8 val)
 {
-	u32 data = 0;
-
-	if (pci_config_access (PCI_CMD_READ, dev, reg, &data))
-		return -1;
-
-	data = (data & ~(0xff << ((reg & 3) << 3))) | (val <<
-						       ((reg & 3) << 3));
-
-	if (pci_config_access (PCI_CMD_WRITE, dev, reg, &data))
-		return -1;
-
-	return 0;
+	return pci_shadow_write_part(dev, reg, val, 0xff);
 }
 
 
 static int aspeed_pci_write_config_word (u32 hose, u32 dev, u32 reg, u16 val)
 {
-	u32 data = 0;
-
 	if (reg & 1)
 		return -1;
 
-	if (pci_config_access (PCI_CMD_READ, dev, reg, &data))
-		return -1;
-
-	data = (data & ~(0xffff << ((reg & 3) << 3))) | (val <<
-							 ((reg & 3) << 3));
-
-	if (pci_config_access (PCI_CMD_WRITE, dev, reg, &data))
-		return -1;
-
-	return 0;
+	return pci_shadow_write_part(dev, reg, val, 0xffff);
 }
 
 static int aspeed_pci_write_config_dword (u32 hose, u32 dev, u32 reg, u32 val)
 {
-	u32 data;
-
 	if (reg & 3) {
 		return -1;
 	}
 
-	data = val;
-
-	if (pci_config_access (PCI_CMD_WRITE, dev, reg, &data))
-		return -1;
-
-	return (0);
+	return pci_shadow_write(dev, reg, val);
 }
 
 /*
@@ -237,7 +386,11 @@ void aspeed_init_pci (struct pci_controller *hose)
 
 	pci_register_hose (hose);
 
+	pci_shadow_flush();
+	bootstage_start(BOOTSTAGE_ID_ACCUM_PCI, "pci_scan");
 	hose->last_busno = pci_hose_scan (hose);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_PCI);
+	debug("PCI: scan took %lu config cycles\n", pci_cycles);
 
 	return;
 }
@@ -0,0 +1,424 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * AST2050 DDR2 controller init
+ *
+ * ast_sdram_init() is called from lowlevel_init while U-Boot still runs
+ * from flash: the stack is in SRAM, .data/.bss are read-only and there is
+ * no console. Timer 4 has been started by lowlevel_init as a free-running
+ * 1MHz down counter and is used for all delays here.
+ *
+ * The parts are sized by programming the largest geometry and looking for
+ * aliases. Each speed bin then gets a sweep of the MCR68 read delay codes,
+ * checked with the controller's built-in test engine, and the centre of
+ * the passing window of every byte lane is kept.
+ */
+#include <common.h>
+#include <asm/io.h>
+#include "hwreg.h"
+#include "sdram.h"
+
+/* MCR04 bits 5:4 mirror the VGA memory size strap, SCU70 bits 3:2 */
+#define SCU_STRAP_VGA_MASK		0x0000000C
+
+/* MCR28: mode register commands */
+#define SDRAM_MODE_SET_MRS		0x00000001
+#define SDRAM_MODE_SET_EMRS		0x00000003
+#define SDRAM_MODE_SET_PRECHARGE	0x00000005
+#define SDRAM_MODE_SET_REFRESH		0x00000007
+
+#define SDRAM_MRS_DLL_RESET		0x00000100
+#define SDRAM_EMRS_ODT_75		0x00000040
+#define SDRAM_EMRS_OCD_DEFAULT		0x00000380
+
+/* MCR0C: refresh enabled, init sequence refresh period */
+#define SDRAM_REFRESH_INIT(r)		(((r) & ~0xFF) | 0x08)
+
+#define SDRAM_PWR_CKE			0x00000001
+#define SDRAM_PWR_NORMAL		0x00007C03
+
+/* MCR68: one delay code per byte lane */
+#define SDRAM_DLL_CODES			32
+#define SDRAM_DLL_LANE(code)		((code) * 0x01010101)
+
+#define SDRAM_CAL_LEN			(64 << 10)
+#define SDRAM_BW_LEN			(4 << 20)
+#define SDRAM_TEST_TIMEOUT_US		1000000
+
+/*
+ * Speed bins, fastest first. A bin is only kept if its delay sweep finds a
+ * passing window on every lane, so an entry for a faster grade of part
+ * costs nothing on boards that can't run it.
+ */
+const struct ast_sdram_timing ast_sdram_timings[] = {
+	{
+		.name		= "DDR2-400",
+		.mhz		= 200,
+		.mpll		= 0x000041F0,
+		.mpll_compat	= 0x00004C41,
+		.ac1		= 0x22201725,
+		.ac2		= 0x1E29011A,
+		.delay		= 0x00C82222,
+		.refresh	= 0x00005A21,
+		.mrs		= 0x00000632,
+		.io_mode	= 0x032AA02A,
+		.dll1		= 0x002D3000,
+		.dll2		= 0x02020202,
+		.dll3		= 0x00909090,
+	},
+	{ .name = NULL }
+};
+
+/* Largest first, each half the size of the one before */
+const struct ast_sdram_geometry ast_sdram_geometries[] = {
+	{ "1Gbit",	0x00000D89,	128 << 20 },
+	{ "512Mbit",	0x00000585,	64 << 20 },
+	{ .name = NULL }
+};
+
+static inline u32 sdram_now(void)
+{
+	return readl(TIMER4_COUNT_REG);
+}
+
+static void sdram_udelay(u32 us)
+{
+	u32 start = sdram_now();
+
+	while (start - sdram_now() < us)
+		;
+}
+
+static void sdram_program(const struct ast_sdram_timing *t, u32 config,
+			  u32 dll2)
+{
+	u32 reg;
+
+	writel(t->mpll, SCU_M_PLL_PARAM_REG);
+	sdram_udelay(400);
+
+	writel(AST_SDRAM_UNLOCK_KEY, SDRAM_PROTECTION_KEY_REG);
+	writel(t->dll3, SDRAM_DLL_CTRL_REG3);
+	writel(0x00050000, SDRAM_DLL_CTRL_REG1);
+	writel(config, SDRAM_CONFIG_REG);
+	writel(0x0011030F, SDRAM_GRAP_MEM_PROTECTION_REG);
+	writel(t->ac1, SDRAM_NSPEED_REG1);
+	writel(t->ac2, SDRAM_NSPEED_REG2);
+	writel(t->delay, SDRAM_NSPEED_DELAY_CTRL_REG);
+	writel(t->ac1, SDRAM_LSPEED_REG1);
+	writel(t->ac2, SDRAM_LSPEED_REG2);
+	writel(t->delay, SDRAM_LSPEED_DELAY_CTRL_REG);
+	writel(0xFFFFFF82, SDRAM_PAGE_MISS_LATENCY_MASK_REG);
+	/* arbitration and ECC: all off */
+	for (reg = SDRAM_PRIORITY_GROUP_SET_REG;
+	     reg <= SDRAM_ECC_ADDR_FIRST_ERR_REG; reg += 4)
+		writel(0, reg);
+	writel(t->io_mode, SDRAM_IO_BUFF_MODE_REG);
+	writel(t->dll1, SDRAM_DLL_CTRL_REG1);
+	writel(dll2, SDRAM_DLL_CTRL_REG2);
+	for (reg = SDRAM_TEST_CTRL_STATUS_REG;
+	     reg <= SDRAM_TEST_INIT_VALUE_REG; reg += 4)
+		writel(0, reg);
+
+	/* JEDEC DDR2 power-up sequence */
+	writel(SDRAM_PWR_CKE, SDRAM_PWR_CTRL_REG);
+	sdram_udelay(400);
+	writel(t->mrs | SDRAM_MRS_DLL_RESET, SDRAM_MRS_EMRS2_MODE_SET_REG);
+	writel(SDRAM_EMRS_ODT_75, SDRAM_MRS_EMRS3_MODE_SET_REG);
+	writel(SDRAM_MODE_SET_PRECHARGE, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_MODE_SET_REFRESH, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_MODE_SET_EMRS, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_MODE_SET_MRS, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_REFRESH_INIT(t->refresh), SDRAM_REFRESH_TIMING_REG);
+	writel(t->mrs, SDRAM_MRS_EMRS2_MODE_SET_REG);
+	writel(SDRAM_MODE_SET_MRS, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_EMRS_ODT_75 | SDRAM_EMRS_OCD_DEFAULT,
+	       SDRAM_MRS_EMRS3_MODE_SET_REG);
+	writel(SDRAM_MODE_SET_EMRS, SDRAM_MODE_SET_CTRL_REG);
+	writel(SDRAM_EMRS_ODT_75, SDRAM_MRS_EMRS3_MODE_SET_REG);
+	writel(SDRAM_MODE_SET_EMRS, SDRAM_MODE_SET_CTRL_REG);
+	writel(t->refresh, SDRAM_REFRESH_TIMING_REG);
+	writel(SDRAM_PWR_NORMAL, SDRAM_PWR_CTRL_REG);
+	writel(t->mpll_compat, AST2100_COMPATIBLE_SCU_MPLL_PARA);
+}
+
+void ast_sdram_engine_start(u32 window, u32 pattern, u32 mode)
+{
+	writel(window, SDRAM_TEST_START_ADDR_LENGTH_REG);
+	writel(pattern, SDRAM_TEST_INIT_VALUE_REG);
+	writel(0, SDRAM_TEST_FAIL_DQ_BIT_REG);
+	writel(0, SDRAM_TEST_CTRL_STATUS_REG);
+	writel(mode, SDRAM_TEST_CTRL_STATUS_REG);
+}
+
+int ast_sdram_engine_poll(u32 *fail)
+{
+	u32 status = readl(SDRAM_TEST_CTRL_STATUS_REG);
+
+	if (!(status & (AST_SDRAM_TEST_DONE | AST_SDRAM_TEST_FAIL)))
+		return 0;
+
+	*fail = 0;
+	if (status & AST_SDRAM_TEST_FAIL) {
+		*fail = readl(SDRAM_TEST_FAIL_DQ_BIT_REG);
+		if (!*fail)
+			*fail = ~0;
+	}
+	ast_sdram_engine_stop();
+
+	return 1;
+}
+
+void ast_sdram_engine_stop(void)
+{
+	writel(0, SDRAM_TEST_CTRL_STATUS_REG);
+}
+
+/*
+ * Run one test engine pass. Returns 0 if it passed, otherwise the failing
+ * DQ bits (all of them if the engine hung).
+ */
+static u32 sdram_test(u32 window, u32 pattern, u32 mode)
+{
+	u32 start = sdram_now();
+	u32 fail;
+
+	ast_sdram_engine_start(window, pattern, mode);
+	while (!ast_sdram_engine_poll(&fail)) {
+		if (start - sdram_now() > SDRAM_TEST_TIMEOUT_US) {
+			ast_sdram_engine_stop();
+			return ~0;
+		}
+	}
+
+	return fail;
+}
+
+#ifndef CONFIG_DDRII_DEFAULT_DELAY
+static u32 sdram_check(u32 len)
+{
+	static const u32 patterns[] = {
+		0xFF00FF00, 0xAA55AA55, 0x92CC4D6E, 0x7C61D253,
+	};
+	u32 window = AST_SDRAM_TEST_WINDOW(0, len);
+	u32 fail = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(patterns); i++) {
+		fail |= sdram_test(window, patterns[i], AST_SDRAM_TEST_BURST |
+				   (i << AST_SDRAM_TEST_DATAGEN_SHIFT));
+		fail |= sdram_test(window, patterns[i], AST_SDRAM_TEST_SINGLE |
+				   (i << AST_SDRAM_TEST_DATAGEN_SHIFT));
+	}
+
+	return fail;
+}
+
+/*
+ * Sweep all MCR68 codes at once and sort the failures into byte lanes
+ * using the failing DQ bits, then centre each lane in its longest passing
+ * run. Returns 0 and leaves the result programmed, or -1 if some lane
+ * never passed.
+ */
+static int sdram_calibrate(struct ast_sdram_info *info)
+{
+	u32 pass[AST_SDRAM_LANES] = { 0 };
+	u32 fail, mcr68 = 0;
+	int code, lane, run, best, lo;
+
+	for (code = 0; code < SDRAM_DLL_CODES; code++) {
+		writel(SDRAM_DLL_LANE(code), SDRAM_DLL_CTRL_REG2);
+		sdram_udelay(10);
+		fail = sdram_check(SDRAM_CAL_LEN);
+		for (lane = 0; lane < AST_SDRAM_LANES; lane++)
+			if (!(fail & (0xFF << (lane * 8))))
+				pass[lane] |= 1 << code;
+	}
+
+	for (lane = 0; lane < AST_SDRAM_LANES; lane++) {
+		best = 0;
+		lo = 0;
+		run = 0;
+		for (code = 0; code <= SDRAM_DLL_CODES; code++) {
+			if (code < SDRAM_DLL_CODES && (pass[lane] & (1 << code))) {
+				run++;
+				continue;
+			}
+			if (run > best) {
+				best = run;
+				lo = code - run;
+			}
+			run = 0;
+		}
+		if (!best)
+			return -1;
+		info->win_lo[lane] = lo;
+		info->win_hi[lane] = lo + best - 1;
+		mcr68 |= (lo + (best - 1) / 2) << (lane * 8);
+	}
+
+	writel(mcr68, SDRAM_DLL_CTRL_REG2);
+	sdram_udelay(10);
+
+	return sdram_check(SDRAM_CAL_LEN) ? -1 : 0;
+}
+#endif
+
+/* The engine writes the window and reads it back: two bytes per byte */
+static void sdram_measure(struct ast_sdram_info *info)
+{
+	u32 start;
+
+	start = sdram_now();
+	if (sdram_test(AST_SDRAM_TEST_WINDOW(0, SDRAM_BW_LEN), 0,
+		       AST_SDRAM_TEST_BURST))
+		return;
+	info->bw_us = start - sdram_now();
+	info->bw_bytes = 2 * SDRAM_BW_LEN;
+}
+
+static int sdram_geometry(u32 vga)
+{
+#if defined(CONFIG_1G_DDRII)
+	return 0;
+#elif defined(CONFIG_512M_DDRII)
+	return 1;
+#else
+	const struct ast_sdram_timing *t = &ast_sdram_timings[0];
+	long size;
+	int g;
+
+	while (t[1].name)
+		t++;
+	sdram_program(t, ast_sdram_geometries[0].config | vga, t->dll2);
+	size = get_ram_size((long *)PHYS_SDRAM_1, ast_sdram_geometries[0].size);
+
+	for (g = 0; ast_sdram_geometries[g + 1].name; g++)
+		if (size >= ast_sdram_geometries[g].size)
+			break;
+
+	return g;
+#endif
+}
+
+void ast_sdram_init(void)
+{
+	struct ast_sdram_info *info = (void *)CONFIG_ASPEED_SDRAM_INFO;
+	const struct ast_sdram_timing *t;
+	u32 vga, config;
+	int i;
+
+	info->magic = 0;
+	info->flags = 0;
+	info->bw_bytes = 0;
+	info->bw_us = 0;
+	for (i = 0; i < AST_SDRAM_LANES; i++)
+		info->win_lo[i] = info->win_hi[i] = 0;
+
+	vga = (readl(SCU_HW_STRAPPING_REG) & SCU_STRAP_VGA_MASK) << 2;
+	info->geometry = sdram_geometry(vga);
+#if defined(CONFIG_1G_DDRII) || defined(CONFIG_512M_DDRII)
+	info->flags |= AST_SDRAM_GEOMETRY_FIXED;
+#endif
+	config = ast_sdram_geometries[info->geometry].config | vga;
+
+#ifdef CONFIG_DDRII_DEFAULT_DELAY
+	/* no sweep: the slowest bin with its table delays, as validated */
+	for (t = ast_sdram_timings; t[1].name; t++)
+		;
+	sdram_program(t, config, t->dll2);
+	info->flags |= AST_SDRAM_DEFAULT_DELAY;
+#else
+	for (t = ast_sdram_timings; ; t++) {
+		sdram_program(t, config, t->dll2);
+		if (!sdram_calibrate(info)) {
+			info->flags |= AST_SDRAM_CALIBRATED;
+			break;
+		}
+		if (!t[1].name) {
+			/* nothing passed: the slowest bin, as validated */
+			sdram_program(t, config, t->dll2);
+			info->flags |= AST_SDRAM_FALLBACK;
+			break;
+		}
+	}
+#endif
+
+	info->timing = t - ast_sdram_timings;
+	info->mcr04 = readl(SDRAM_CONFIG_REG);
+	info->mcr68 = readl(SDRAM_DLL_CTRL_REG2);
+	sdram_measure(info);
+	info->magic = AST_SDRAM_INFO_MAGIC;
+}
+
+u32 ast_sdram_vga_size(void)
+{
+	u32 strap = readl(SCU_HW_STRAPPING_REG) & SCU_STRAP_VGA_MASK;
+
+	return (8 << 20) << (strap >> 2);
+}
+
+const struct ast_sdram_info *ast_sdram_info(void)
+{
+	const struct ast_sdram_info *info = (void *)CONFIG_ASPEED_SDRAM_INFO;
+	int n;
+
+	if (info->magic != AST_SDRAM_INFO_MAGIC)
+		return NULL;
+	for (n = 0; ast_sdram_timings[n].name; n++)
+		;
+	if (info->timing >= n)
+		return NULL;
+	for (n = 0; ast_sdram_geometries[n].name; n++)
+		;
+	if (info->geometry >= n)
+		return NULL;
+
+	return info;
+}
+
+void ast_sdram_report(void)
+{
+	const struct ast_sdram_info *info = ast_sdram_info();
+	const struct ast_sdram_timing *t;
+	int lane;
+
+	puts("DDR2:  ");
+	if (!info) {
+		puts("set up before U-Boot\n");
+		return;
+	}
+
+	t = &ast_sdram_timings[info->timing];
+	printf("%s (%u MHz), %s parts%s, MCR04 %08x MCR68 %08x\n", t->name,
+	       t->mhz, ast_sdram_geometries[info->geometry].name,
+	       info->flags & AST_SDRAM_GEOMETRY_FIXED ? " (fixed)" : "",
+	       info->mcr04, info->mcr68);
+
+	if (info->flags & AST_SDRAM_CALIBRATED) {
+		puts("       delay windows:");
+		for (lane = 0; lane < AST_SDRAM_LANES; lane++)
+			printf(" %02x-%02x", info->win_lo[lane],
+			       info->win_hi[lane]);
+		putc('\n');
+	} else if (info->flags & AST_SDRAM_FALLBACK) {
+		puts("       delay sweep found no window, using defaults\n");
+	} else if (info->flags & AST_SDRAM_DEFAULT_DELAY) {
+		puts("       delay sweep disabled, using defaults\n");
+	}
+
+	if (info->bw_us)
+		printf("       test engine: %u MB/s\n",
+		       info->bw_bytes / info->bw_us);
+}
@@ -0,0 +1,154 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _AST_SDRAM_H_
+#define _AST_SDRAM_H_
+
+/*
+ * The DDR2 init stage runs from flash before DRAM exists, so its stack
+ * and its result record live in the on-chip SRAM. 0x1E720400-0x1E7204FF
+ * is left alone for the LPC patch code.
+ */
+#define AST_SRAM_BASE			0x1E720000
+
+#ifndef CONFIG_ASPEED_SDRAM_INFO
+#define CONFIG_ASPEED_SDRAM_INFO	AST_SRAM_BASE
+#endif
+#ifndef CONFIG_ASPEED_SDRAM_STACK
+#define CONFIG_ASPEED_SDRAM_STACK	(AST_SRAM_BASE + 0x1000)
+#endif
+
+#define AST_SDRAM_UNLOCK_KEY		0xFC600309	/* MCR00 */
+
+/* MCR70: test engine control and status */
+#define AST_SDRAM_TEST_BURST		0x000000C1
+#define AST_SDRAM_TEST_SINGLE		0x00000085
+#define AST_SDRAM_TEST_DATAGEN_SHIFT	3
+#define AST_SDRAM_TEST_DONE		0x00001000
+#define AST_SDRAM_TEST_FAIL		0x00002000
+
+/*
+ * MCR74: test window, an offset into DRAM and a power-of-two length the
+ * offset is aligned to. The engine writes the window, then reads it back.
+ */
+#define AST_SDRAM_TEST_WINDOW(off, len)	((off) | ((len) - 1))
+
+#ifndef __ASSEMBLY__
+
+/* One DDR2 speed bin: everything in the init sequence that depends on it */
+struct ast_sdram_timing {
+	const char *name;
+	unsigned int mhz;
+	u32 mpll;		/* SCU20 */
+	u32 mpll_compat;	/* MCR120, what AST2000 software reads back */
+	u32 ac1;		/* MCR10/MCR14 */
+	u32 ac2;		/* MCR18/MCR1C */
+	u32 delay;		/* MCR20/MCR24 */
+	u32 refresh;		/* MCR0C once the part is up */
+	u32 mrs;		/* MCR2C, without the DLL reset bit */
+	u32 io_mode;		/* MCR60 */
+	u32 dll1;		/* MCR64 */
+	u32 dll2;		/* MCR68, used when calibration finds nothing */
+	u32 dll3;		/* MCR6C */
+};
+
+/* Part geometry, told apart at run time by probing for aliases */
+struct ast_sdram_geometry {
+	const char *name;
+	u32 config;		/* MCR04, before the VGA memory size is added */
+	u32 size;		/* bytes */
+};
+
+#define AST_SDRAM_INFO_MAGIC		0x44445232	/* "DDR2" */
+
+/* ast_sdram_info.flags */
+#define AST_SDRAM_CALIBRATED		0x01	/* MCR68 came from the sweep */
+#define AST_SDRAM_FALLBACK		0x02	/* no bin passed, slowest kept */
+#define AST_SDRAM_GEOMETRY_FIXED	0x04	/* geometry set at build time */
+#define AST_SDRAM_DEFAULT_DELAY		0x08	/* sweep disabled at build time */
+
+#define AST_SDRAM_LANES			4
+
+/* What the init stage chose, left in SRAM for U-Boot proper */
+struct ast_sdram_info {
+	u32 magic;
+	u32 flags;
+	u32 timing;		/* index into ast_sdram_timings[] */
+	u32 geometry;		/* index into ast_sdram_geometries[] */
+	u32 mcr04;
+	u32 mcr68;
+	u8 win_lo[AST_SDRAM_LANES];	/* passing MCR68 codes, per lane */
+	u8 win_hi[AST_SDRAM_LANES];
+	u32 bw_bytes;		/* bytes moved by the test engine ... */
+	u32 bw_us;		/* ... and how long it took */
+};
+
+extern const struct ast_sdram_timing ast_sdram_timings[];
+extern const struct ast_sdram_geometry ast_sdram_geometries[];
+
+/**
+ * Bring up the DDR2 controller
+ *
+ * Called from lowlevel_init with the SCU and SDRAM registers unlocked and
+ * the stack in SRAM. It must not touch .data or .bss and must not print.
+ * Speed bins are tried fastest first; the first one whose delay sweep
+ * finds a passing window is kept and recorded at CONFIG_ASPEED_SDRAM_INFO.
+ * With CONFIG_DDRII_DEFAULT_DELAY there is no sweep, and the slowest bin
+ * is used with the MCR68 value from its table entry.
+ */
+void ast_sdram_init(void);
+
+/**
+ * Return the record left by ast_sdram_init(), or NULL if DRAM was set up
+ * by someone else (e.g. U-Boot restarted without a power cycle)
+ */
+const struct ast_sdram_info *ast_sdram_info(void);
+
+/**
+ * Return the size of the VGA frame buffer, which the SCU70 strap reserves
+ * at the top of DRAM
+ */
+u32 ast_sdram_vga_size(void);
+
+/**
+ * Start the test engine over a window
+ *
+ * The SDRAM registers must be unlocked with AST_SDRAM_UNLOCK_KEY.
+ *
+ * @param window	MCR74 value, see AST_SDRAM_TEST_WINDOW()
+ * @param pattern	Seed for the data generator
+ * @param mode		AST_SDRAM_TEST_BURST or AST_SDRAM_TEST_SINGLE, with
+ *			a data generator number
+ */
+void ast_sdram_engine_start(u32 window, u32 pattern, u32 mode);
+
+/**
+ * Check whether the test engine has finished, and stop it if so
+ *
+ * @param fail	Receives 0 if the pass was clean, else the failing DQ bits
+ * @return 1 if finished, 0 if still running
+ */
+int ast_sdram_engine_poll(u32 *fail);
+
+/**
+ * Stop the test engine, finished or not
+ */
+void ast_sdram_engine_stop(void);
+
+/**
+ * Print the chosen timing, delay windows and measured bandwidth
+ */
+void ast_sdram_report(void);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* _AST_SDRAM_H_ */
@@ -26,10 +26,15 @@ int do_slt (cmd_tbl_t * cmdtp, int flag, int argc, char *argv[])
 {
     int flags = 0;
     int loop  = 1;
+    int dcache = dcache_status();
 	
     if (argc > 1) {
         loop = simple_strtoul(argv[1], NULL, 10);
     }
+
+    /* The MAC and MIC tests run DMA on raw buffers without cache maintenance */
+    if (dcache)
+        dcache_disable();
 	
     do {
 
@@ -94,6 +99,9 @@ do_slt_start:
             
     } while (loop);
 
+    if (dcache)
+        dcache_enable();
+
     return 0;
 }
 /***************************************************/
@@ -0,0 +1,391 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Video capture and compression
+ *
+ * Drives video engine 1 in stream mode: each trigger captures one frame
+ * from the external VGA input into a source buffer and compresses it into
+ * a ring of packets. The CPU drains the ring through the software read
+ * pointer, which also tells the engine how much space it may reuse.
+ */
+#include <common.h>
+#include <command.h>
+#include <asm/errno.h>
+
+#include "type.h"
+#include "vreg.h"
+#include "vdef.h"
+#include "crt.h"
+#include "vfun.h"
+#include "vcapture.h"
+
+#ifdef CONFIG_ASPEED_VIDEO_CAPTURE
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * Hidden from U-Boot at the top of DRAM by CONFIG_SYS_MEM_TOP_HIDE, above
+ * the 2MB of the CRT frame buffer
+ */
+#ifndef CONFIG_ASPEED_VIDEO_BUF
+#define CONFIG_ASPEED_VIDEO_BUF		(CONFIG_SYS_SDRAM_BASE + gd->ram_size + \
+					 (2 << 20))
+#endif
+
+/* Largest mode we leave room for, at four bytes a pixel in YUV444 */
+#define VCAP_MAX_WIDTH		1280
+#define VCAP_MAX_HEIGHT		1024
+#define VCAP_SRC_SIZE		(VCAP_MAX_WIDTH * VCAP_MAX_HEIGHT * INPUT_BITCOUNT_YUV444)
+
+/*
+ * The largest ring the engine supports, 32 packets of 128KB. That is less
+ * than an incompressible frame at the largest mode, so vcap_frame() checks
+ * the size the engine reports against the room that was left.
+ */
+#define VCAP_RING_SIZE		(32 * 128 * 1024)
+
+#define VCAP_SRC1		vBufAlign(CONFIG_ASPEED_VIDEO_BUF)
+#define VCAP_SRC2		(VCAP_SRC1 + VCAP_SRC_SIZE)
+#define VCAP_RING		(VCAP_SRC2 + VCAP_SRC_SIZE)
+#define VCAP_FLAG		(VCAP_RING + VCAP_RING_SIZE)
+
+/* Mode detection and one compressed frame, in ms */
+#define VCAP_DETECT_TIMEOUT	1000
+#define VCAP_FRAME_TIMEOUT	500
+
+static int vcap_running;
+static unsigned int vcap_rd;		/* software read offset */
+static unsigned int vcap_wr;		/* engine write offset */
+
+static int vcap_wait_status(ULONG bit, ulong timeout)
+{
+	ulong start = get_timer(0);
+
+	while (!ReadVideoInterruptHost(0, bit)) {
+		if (get_timer(start) > timeout)
+			return -ETIMEDOUT;
+	}
+	ClearVideoInterruptHost(0, bit);
+
+	return 0;
+}
+
+static int vcap_unlock(void)
+{
+	int i;
+
+	for (i = 0; i < 10; i++) {
+		if (UnlockVideoRegHost(0, VIDEO_UNLOCK_KEY) == VIDEO_UNLOCK)
+			return 0;
+	}
+
+	return -EBUSY;
+}
+
+int vcap_detect(struct vcap_mode *mode)
+{
+	ULONG edge_h, edge_v, status;
+	int ret;
+
+	CheckOnStartHost();
+	ret = vcap_unlock();
+	if (ret)
+		return ret;
+	vcap_running = 0;
+
+	WriteMemoryLongHost(VIDEO_REG_BASE, VIDEO1_CONTROL_REG,
+			    EXTERNAL_VGA_SOURCE << EXTERNAL_SOURCE_BIT);
+
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO_MODE_DETECTION_PARAM_REG,
+		(MODEDETECTION_VERTICAL_STABLE_MAXIMUM << VER_STABLE_MAX_BIT) |
+		(MODEDETECTION_HORIZONTAL_STABLE_MAXIMUM << HOR_STABLE_MAX_BIT) |
+		(MODEDETECTION_VERTICAL_STABLE_THRESHOLD << VER_STABLE_THRES_BIT) |
+		(MODEDETECTION_HORIZONTAL_STABLE_THRESHOLD << HOR_STABLE_THRES_BIT),
+		VER_STABLE_MAX_BIT_MASK | HOR_STABLE_MAX_BIT_MASK |
+		VER_STABLE_THRES_BIT_MASK | HOR_STABLE_THRES_BIT_MASK);
+
+	/* the watchdog would restart detection while we poll */
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG,
+				    WATCH_DOG_OFF << WATCH_DOG_ENABLE_BIT, WATCH_DOG_EN_MASK);
+
+	ClearVideoInterruptHost(0, VIDEO1_MODE_DETECTION_READY_CLEAR);
+	StartModeDetectionTriggerHost(0, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG);
+	ret = vcap_wait_status(VIDEO1_MODE_DETECTION_READY_READ,
+			       VCAP_DETECT_TIMEOUT);
+	StopModeDetectionTriggerHost(0, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG);
+	if (ret)
+		return ret;
+
+	edge_h = ReadMemoryLongHost(VIDEO_REG_BASE, VIDE1_MODE_DETECTION_EDGE_H_REG);
+	edge_v = ReadMemoryLongHost(VIDEO_REG_BASE, VIDE1_MODE_DETECTION_EDGE_V_REG);
+	status = ReadMemoryLongHost(VIDEO_REG_BASE, VIDEO1_MODE_DETECTION_STATUS_READ_REG);
+
+	mode->hstart = (edge_h & LEFT_EDGE_LOCATION_MASK) >> LEFT_EDGE_LOCATION_BIT;
+	mode->hend = (edge_h & RIGHT_EDGE_LOCATION_MASK) >> RIGHT_EDGE_LOCATION_BIT;
+	mode->vstart = (edge_v & TOP_EDGE_LOCATION_MASK) >> TOP_EDGE_LOCATION_BIT;
+	mode->vend = (edge_v & BOTTOM_EDGE_LOCATION_MASK) >> BOTTOM_EDGE_LOCATION_BIT;
+	if (mode->hend < mode->hstart || mode->vend < mode->vstart)
+		return -ETIMEDOUT;
+
+	mode->width = mode->hend - mode->hstart + 1;
+	mode->height = mode->vend - mode->vstart + 1;
+	mode->hpol_negative = !(status & HSYNC_POLARITY_READ);
+	mode->vpol_negative = !(status & VSYNC_POLARITY_READ);
+	mode->analog = !!(status & ANALONG_DIGITAL_READ);
+
+	return 0;
+}
+
+int vcap_init(const struct vcap_mode *mode)
+{
+	int ret;
+
+	if (!mode->width || mode->width > VCAP_MAX_WIDTH ||
+	    !mode->height || mode->height > VCAP_MAX_HEIGHT)
+		return -EINVAL;
+
+	ret = vcap_unlock();
+	if (ret)
+		return ret;
+
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_TIMEING_GEN_HOR_REG,
+		(mode->hend << VIDEO_HDE_END_BIT) | (mode->hstart << VIDEO_HDE_START_BIT),
+		VIDEO_HDE_END_MASK | VIDEO_HDE_START_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_TIMEING_GEN_V_REG,
+		(mode->vend << VIDEO_VDE_END_BIT) | (mode->vstart << VIDEO_VDE_START_BIT),
+		VIDEO_VDE_END_MASK | VIDEO_VDE_START_MASK);
+
+	g_CAPTURE_VIDEO1_BUF1_ADDR = VCAP_SRC1;
+	g_CAPTURE_VIDEO1_BUF2_ADDR = VCAP_SRC2;
+	g_VIDEO1_COMPRESS_BUF_ADDR = VCAP_RING;
+	g_VIDEO1_FLAG_BUF_ADDR = VCAP_FLAG;
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_BUF_1_ADDR_REG, VCAP_SRC1, BUF_1_ADDR_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_BUF_2_ADDR_REG, VCAP_SRC2, BUF_2_ADDR_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_BUF_ADDR_REG, VCAP_RING, COMPRESS_BUF_ADDR_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_FLAG_BUF_ADDR_REG, VCAP_FLAG, FLAG_BUF_ADDR_MASK);
+
+	/* the engine setup takes its window size from these */
+	g_DefWidth = mode->width;
+	g_DefHeight = mode->height;
+	InitializeVideoEngineHost(0, VIDEO1,
+				  mode->hpol_negative ? HOR_NEGATIVE : HOR_POSITIVE,
+				  mode->vpol_negative ? VER_NEGATIVE : VER_POSITIVE);
+
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_STREAM_BUF_SIZE,
+		(PACKET_SIZE_128KB << STREAM_PACKET_SIZE_BIT) |
+		(PACKETS_32 << RING_BUF_PACKET_NUM_BIT),
+		STREAM_PACKET_SIZE_MASK | RING_BUF_PACKET_NUM_MASK);
+
+	/* empty ring, then arm the codec so each capture trigger compresses */
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG,
+				    0, VIDEO_CODEC_TRIGGER | VIDEO_CAPTURE_TRIGGER);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_BUF_READ_OFFSET_REG, 0, COMPRESS_BUF_READ_OFFSET_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_BUF_CODEC_OFFSET_READ, 0, BUF_CODEC_OFFSET_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_BUF_PROCESS_OFFSET_REG, 0, COMPRESS_BUF_PROCESS_OFFSET_MASK);
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_FRAME_END_READ, 0, COMPRESS_FRAME_END_READ_MASK);
+	ClearVideoInterruptHost(0, VIDEO1_COMPRESS_COMPLETE_CLEAR);
+	StartVideoCodecTriggerHost(0, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG);
+
+	vcap_rd = 0;
+	vcap_wr = 0;
+	vcap_running = 1;
+
+	return 0;
+}
+
+static unsigned int vcap_used(unsigned int rd, unsigned int wr)
+{
+	return (wr - rd) & (VCAP_RING_SIZE - 1);
+}
+
+/* Move the read offset, handing the space before it back to the engine */
+static void vcap_set_rd(unsigned int rd)
+{
+	vcap_rd = rd;
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_BUF_READ_OFFSET_REG,
+				    vcap_rd, COMPRESS_BUF_READ_OFFSET_MASK);
+}
+
+/* Drop stale lines covering ring data the engine wrote since last time */
+static void vcap_invalidate(unsigned int from, unsigned int to)
+{
+	ulong start = VCAP_RING + (from & ~(ARCH_DMA_MINALIGN - 1));
+	ulong end;
+
+	if (to < from) {
+		invalidate_dcache_range(start, VCAP_RING + VCAP_RING_SIZE);
+		start = VCAP_RING;
+	}
+	end = VCAP_RING + ALIGN(to, ARCH_DMA_MINALIGN);
+	if (end > start)
+		invalidate_dcache_range(start, end);
+}
+
+int vcap_frame(void)
+{
+	unsigned int wr, size;
+	int ret;
+
+	if (!vcap_running)
+		return -ENODEV;
+
+	StartVideoCaptureTriggerHost(0, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG);
+	ret = vcap_wait_status(VIDEO1_COMPRESS_COMPLETE_READ, VCAP_FRAME_TIMEOUT);
+	if (ret)
+		return ret;
+
+	wr = ReadMemoryLongHost(VIDEO_REG_BASE, VIDEO1_BUF_CODEC_OFFSET_READ) &
+		BUF_CODEC_OFFSET_MASK;
+	wr &= VCAP_RING_SIZE - 1;
+
+	/*
+	 * A frame larger than the free space wraps onto data not read yet,
+	 * and the offsets alone cannot tell. Drop the lot rather than hand
+	 * back a corrupt frame.
+	 */
+	size = (ReadMemoryLongHost(VIDEO_REG_BASE, VIDEO1_COMPRESS_FRAME_SIZE_REG) &
+		COMPRESS_FRAME_SIZE_READ_MASK) * 4;
+	if (size >= VCAP_RING_SIZE - vcap_pending()) {
+		debug("%s: %u byte frame overflows the ring\n", __func__, size);
+		vcap_wr = wr;
+		vcap_set_rd(wr);
+		return -ENOSPC;
+	}
+
+	vcap_invalidate(vcap_wr, wr);
+	ret = vcap_used(vcap_wr, wr);
+	vcap_wr = wr;
+
+	return ret;
+}
+
+unsigned int vcap_pending(void)
+{
+	return vcap_used(vcap_rd, vcap_wr);
+}
+
+unsigned int vcap_read(void *dst, unsigned int len)
+{
+	unsigned int avail = vcap_pending();
+	unsigned int done = 0, n;
+
+	if (len > avail)
+		len = avail;
+
+	while (done < len) {
+		n = min(len - done, VCAP_RING_SIZE - vcap_rd);
+		memcpy((u8 *)dst + done, (void *)(VCAP_RING + vcap_rd), n);
+		vcap_rd = (vcap_rd + n) & (VCAP_RING_SIZE - 1);
+		done += n;
+	}
+	vcap_set_rd(vcap_rd);
+
+	return done;
+}
+
+void vcap_stop(void)
+{
+	WriteMemoryLongWithMASKHost(VIDEO_REG_BASE, VIDEO1_ENGINE_SEQUENCE_CONTROL_REG,
+				    0, VIDEO_CODEC_TRIGGER | VIDEO_CAPTURE_TRIGGER);
+	vcap_running = 0;
+	vcap_rd = 0;
+	vcap_wr = 0;
+}
+
+static struct vcap_mode vcap_mode;
+
+static int vcap_start(void)
+{
+	int ret;
+
+	ret = vcap_detect(&vcap_mode);
+	if (ret) {
+		printf("No video input\n");
+		return ret;
+	}
+
+	ret = vcap_init(&vcap_mode);
+	if (ret)
+		printf("Cannot capture %ux%u: %d\n", vcap_mode.width,
+		       vcap_mode.height, ret);
+
+	return ret;
+}
+
+static int do_vcap(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	ulong addr = load_addr;
+	unsigned int len;
+	int ret;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	if (!strcmp(argv[1], "detect")) {
+		if (vcap_detect(&vcap_mode)) {
+			printf("No video input\n");
+			return CMD_RET_FAILURE;
+		}
+		printf("%ux%u %s, hsync %c, vsync %c\n", vcap_mode.width,
+		       vcap_mode.height, vcap_mode.analog ? "analog" : "digital",
+		       vcap_mode.hpol_negative ? '-' : '+',
+		       vcap_mode.vpol_negative ? '-' : '+');
+		return CMD_RET_SUCCESS;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		vcap_stop();
+		return CMD_RET_SUCCESS;
+	}
+
+	if (strcmp(argv[1], "frame"))
+		return CMD_RET_USAGE;
+
+	if (argc > 2)
+		addr = simple_strtoul(argv[2], NULL, 16);
+
+	if (!vcap_running && vcap_start())
+		return CMD_RET_FAILURE;
+
+	/* throw away anything a previous caller left behind */
+	vcap_set_rd(vcap_wr);
+	ret = vcap_frame();
+	if (ret < 0) {
+		printf("Capture failed: %d\n", ret);
+		vcap_stop();
+		return CMD_RET_FAILURE;
+	}
+
+	len = vcap_read((void *)addr, ret);
+	printf("%ux%u frame, %u bytes compressed at %08lx\n", vcap_mode.width,
+	       vcap_mode.height, len, addr);
+
+	/* so that tftpput and friends can pick it up */
+	load_addr = addr;
+	setenv_hex("fileaddr", addr);
+	setenv_hex("filesize", len);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	vcap,	3,	0,	do_vcap,
+	"capture and compress video input",
+	"detect - show the timing of the VGA input\n"
+	"vcap frame [addr] - capture one compressed frame to addr\n"
+	"vcap stop - stop the video engine"
+);
+
+#endif /* CONFIG_ASPEED_VIDEO_CAPTURE */
@@ -0,0 +1,81 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef _VCAPTURE_H_
+#define _VCAPTURE_H_
+
+/* Input timing found by the mode detection unit */
+struct vcap_mode {
+	unsigned int width;
+	unsigned int height;
+	unsigned int hstart, hend;	/* active area, in pixel clocks */
+	unsigned int vstart, vend;	/* active area, in lines */
+	int hpol_negative;
+	int vpol_negative;
+	int analog;
+};
+
+/**
+ * Run mode detection on the external VGA input
+ *
+ * @param mode	Receives the detected timing
+ * @return 0 if ok, -ETIMEDOUT if no stable signal was found
+ */
+int vcap_detect(struct vcap_mode *mode);
+
+/**
+ * Set up video engine 1 to capture and compress the given mode
+ *
+ * The capture buffers and the compressed stream ring are carved out of
+ * DRAM at CONFIG_ASPEED_VIDEO_BUF. The ring starts out empty.
+ *
+ * @param mode	Timing from vcap_detect()
+ * @return 0 if ok, -EINVAL if the mode does not fit the buffers, -EBUSY
+ * if the video registers stay locked
+ */
+int vcap_init(const struct vcap_mode *mode);
+
+/**
+ * Capture one frame and compress it into the stream ring
+ *
+ * The engine stalls when the ring is full, so the previous frame should
+ * have been drained with vcap_read() first.
+ *
+ * @return size of the compressed frame in bytes, -ENODEV if vcap_init()
+ * has not been called, -ETIMEDOUT if the engine hung, -ENOSPC if the
+ * frame did not fit in the ring (its contents are then discarded)
+ */
+int vcap_frame(void);
+
+/**
+ * Number of compressed bytes waiting in the stream ring
+ */
+unsigned int vcap_pending(void);
+
+/**
+ * Drain compressed data from the stream ring
+ *
+ * Copies up to len bytes and hands the space back to the engine, so the
+ * stream can be forwarded in packet-sized pieces as it is produced.
+ *
+ * @param dst	Buffer to copy to
+ * @param len	Size of dst
+ * @return number of bytes copied
+ */
+unsigned int vcap_read(void *dst, unsigned int len);
+
+/**
+ * Stop the engine and discard anything left in the ring
+ */
+void vcap_stop(void);
+
+#endif /* _VCAPTURE_H_ */
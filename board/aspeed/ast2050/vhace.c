@@ -11,6 +11,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #define HASH_GLOBALS
+#include <common.h>
 #include "type.h"
 #include "vdef.h"
 #include "vhace.h"
@@ -57,6 +58,10 @@ void HashAst3000(ULONG ulLength, ULONG *output, ULONG ulHashMode)
     do {
     	ulTemp = ReadMemoryLongHost(VHAC_REG_BASE, VREG_HASH_STATUS_OFFSET);
     } while (ulTemp & VHASH_BUSY);	
+
+    /* the digest was written by the engine behind the D-cache */
+    invalidate_dcache_range(g_HashDstBuffer & ~(ARCH_DMA_MINALIGN - 1),
+                            ALIGN(g_HashDstBuffer + ulDigestLength, ARCH_DMA_MINALIGN));
     	
     for (i=0; i<ulDigestLength/4; i++)
     {
@@ -0,0 +1,268 @@
+/*
+ *  (c) 2017 Raptor Engineering, LLC
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Framebuffer console on the CRT (local VGA port)
+ *
+ * The CRT scans a 32bpp framebuffer in DRAM. Fills, scrolls and bitmap
+ * copies for cfb_console are done by the 2D engine, which is much faster
+ * than the CPU at moving whole screens.
+ */
+#include <common.h>
+#include <video_fb.h>
+#include <asm/io.h>
+
+#include "type.h"
+#include "vreg.h"
+#include "vdef.h"
+#include "vesa.h"
+#include "vfun.h"
+#include "crt.h"
+#include "ast2d.h"
+
+#ifdef CONFIG_VIDEO_AST2050
+
+#if !defined(CONFIG_SYS_DCACHE_OFF) && !defined(CONFIG_SYS_ARM_CACHE_WRITETHROUGH)
+#error "The 2D engine needs the D-cache off or write-through"
+#endif
+
+/* Hidden from U-Boot at the top of DRAM by CONFIG_SYS_MEM_TOP_HIDE */
+#ifndef CONFIG_ASPEED_FB_ADDR
+#define CONFIG_ASPEED_FB_ADDR		(CONFIG_SYS_SDRAM_BASE + gd->ram_size)
+#endif
+#ifndef CONFIG_ASPEED_FB_WIDTH
+#define CONFIG_ASPEED_FB_WIDTH		800
+#define CONFIG_ASPEED_FB_HEIGHT		600
+#endif
+
+#define FB_BPP		4
+#define FB_PITCH	(CONFIG_ASPEED_FB_WIDTH * FB_BPP)
+
+/* One 2D command never takes this long (ms) */
+#define AST2D_TIMEOUT	100
+
+/* Past this size dropping the whole D-cache beats walking the range */
+#define FB_INVAL_ALL_LEN	(32 * 1024)
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static GraphicDevice ast_gd;
+static int ast2d_ok;
+
+static int ast2d_wait(void)
+{
+	ulong start = get_timer(0);
+
+	while (readl(AST2D_STATUS) & AST2D_STATUS_BUSY) {
+		if (get_timer(start) > AST2D_TIMEOUT) {
+			puts("2D engine hung, drawing with the CPU\n");
+			ast2d_ok = 0;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * The engine writes the framebuffer behind the D-cache. The cache is
+ * write-through, so nothing dirty can be lost by dropping lines.
+ */
+static void fb_invalidate(unsigned int y, unsigned int rows)
+{
+	ulong start = ast_gd.frameAdrs + y * FB_PITCH;
+	ulong len = rows * FB_PITCH;
+
+	if (!dcache_status())
+		return;
+	if (len >= FB_INVAL_ALL_LEN)
+		invalidate_dcache_all();
+	else
+		invalidate_dcache_range(start & ~(ARCH_DMA_MINALIGN - 1),
+					ALIGN(start + len, ARCH_DMA_MINALIGN));
+}
+
+static int ast2d_run(u32 cmd, ulong src, u32 src_pitch, u32 src_xy,
+		     u32 dst_xy, u32 rect, u32 fg)
+{
+	writel(src, AST2D_SRC_BASE);
+	writel(src_pitch << AST2D_PITCH_SHIFT, AST2D_SRC_PITCH);
+	writel(ast_gd.frameAdrs, AST2D_DST_BASE);
+	writel((FB_PITCH << AST2D_PITCH_SHIFT) | AST2D_DST_HEIGHT_MASK,
+	       AST2D_DST_PITCH);
+	writel(src_xy, AST2D_SRC_XY);
+	writel(dst_xy, AST2D_DST_XY);
+	writel(rect, AST2D_RECT_XY);
+	writel(fg, AST2D_FG);
+	writel(cmd | AST2D_CMD_COLOR_32, AST2D_CMD);
+
+	return ast2d_wait();
+}
+
+static inline u32 ast2d_xy(unsigned int x, unsigned int y)
+{
+	return ((x & AST2D_XY_MASK) << AST2D_X_SHIFT) | (y & AST2D_XY_MASK);
+}
+
+void video_hw_rectfill(unsigned int bpp, unsigned int dst_x,
+		       unsigned int dst_y, unsigned int dim_x,
+		       unsigned int dim_y, unsigned int color)
+{
+	unsigned int x, y;
+	u32 *p;
+
+	if (!dim_x || !dim_y)
+		return;
+
+	if (ast2d_ok &&
+	    !ast2d_run(AST2D_CMD_BITBLT | AST2D_CMD_PAT_FGCOLOR |
+		       (AST2D_ROP_PATCOPY << AST2D_CMD_ROP_SHIFT),
+		       0, 0, 0, ast2d_xy(dst_x, dst_y),
+		       ast2d_xy(dim_x, dim_y), color)) {
+		fb_invalidate(dst_y, dim_y);
+		return;
+	}
+
+	for (y = dst_y; y < dst_y + dim_y; y++) {
+		p = (u32 *)(ast_gd.frameAdrs + y * FB_PITCH) + dst_x;
+		for (x = 0; x < dim_x; x++)
+			*p++ = color;
+	}
+}
+
+void video_hw_bitblt(unsigned int bpp, unsigned int src_x,
+		     unsigned int src_y, unsigned int dst_x,
+		     unsigned int dst_y, unsigned int dim_x,
+		     unsigned int dim_y)
+{
+	u32 cmd = AST2D_CMD_BITBLT | (AST2D_ROP_SRCCOPY << AST2D_CMD_ROP_SHIFT);
+	unsigned int y;
+
+	if (!dim_x || !dim_y)
+		return;
+
+	if (ast2d_ok) {
+		/* walk bottom-up when moving down so rows aren't overwritten */
+		if (dst_y > src_y) {
+			cmd |= AST2D_CMD_Y_DEC;
+			src_y += dim_y - 1;
+			dst_y += dim_y - 1;
+		}
+		if (!ast2d_run(cmd, ast_gd.frameAdrs, FB_PITCH,
+			       ast2d_xy(src_x, src_y), ast2d_xy(dst_x, dst_y),
+			       ast2d_xy(dim_x, dim_y), 0)) {
+			if (cmd & AST2D_CMD_Y_DEC)
+				dst_y -= dim_y - 1;
+			fb_invalidate(dst_y, dim_y);
+			return;
+		}
+		if (cmd & AST2D_CMD_Y_DEC) {
+			src_y -= dim_y - 1;
+			dst_y -= dim_y - 1;
+		}
+	}
+
+	for (y = 0; y < dim_y; y++) {
+		unsigned int row = dst_y > src_y ? dim_y - 1 - y : y;
+
+		memmove((void *)(ast_gd.frameAdrs + (dst_y + row) * FB_PITCH +
+				 dst_x * FB_BPP),
+			(void *)(ast_gd.frameAdrs + (src_y + row) * FB_PITCH +
+				 src_x * FB_BPP),
+			dim_x * FB_BPP);
+	}
+}
+
+void video_hw_memblt(unsigned int bpp, const void *src, int src_pitch,
+		     unsigned int dst_x, unsigned int dst_y,
+		     unsigned int dim_x, unsigned int dim_y)
+{
+	const u8 *row = src;
+	unsigned int y;
+
+	if (!dim_x || !dim_y)
+		return;
+
+	/* the engine reads the bitmap straight from DRAM */
+	if (ast2d_ok && src_pitch > 0 && !(src_pitch & 7) &&
+	    !((ulong)src & 7)) {
+		flush_dcache_range((ulong)src & ~(ARCH_DMA_MINALIGN - 1),
+				   ALIGN((ulong)src + src_pitch * dim_y,
+					 ARCH_DMA_MINALIGN));
+		if (!ast2d_run(AST2D_CMD_BITBLT |
+			       (AST2D_ROP_SRCCOPY << AST2D_CMD_ROP_SHIFT),
+			       (ulong)src, src_pitch, 0,
+			       ast2d_xy(dst_x, dst_y), ast2d_xy(dim_x, dim_y),
+			       0)) {
+			fb_invalidate(dst_y, dim_y);
+			return;
+		}
+	}
+
+	/* bottom-up bitmaps come with a negative pitch: one row at a time */
+	for (y = 0; y < dim_y; y++, row += src_pitch) {
+		if (ast2d_ok && !((ulong)row & 7)) {
+			flush_dcache_range((ulong)row & ~(ARCH_DMA_MINALIGN - 1),
+					   ALIGN((ulong)row + dim_x * FB_BPP,
+						 ARCH_DMA_MINALIGN));
+			if (!ast2d_run(AST2D_CMD_BITBLT |
+				       (AST2D_ROP_SRCCOPY << AST2D_CMD_ROP_SHIFT),
+				       (ulong)row, dim_x * FB_BPP, 0,
+				       ast2d_xy(dst_x, dst_y + y),
+				       ast2d_xy(dim_x, 1), 0))
+				continue;
+		}
+		memcpy((void *)(ast_gd.frameAdrs + (dst_y + y) * FB_PITCH +
+				dst_x * FB_BPP), row, dim_x * FB_BPP);
+	}
+	if (ast2d_ok)
+		fb_invalidate(dst_y, dim_y);
+}
+
+void video_set_lut(unsigned int index, unsigned char r, unsigned char g,
+		   unsigned char b)
+{
+}
+
+void *video_hw_init(void)
+{
+	GraphicDevice *pGD = &ast_gd;
+
+	pGD->frameAdrs = CONFIG_ASPEED_FB_ADDR;
+	pGD->winSizeX = CONFIG_ASPEED_FB_WIDTH;
+	pGD->winSizeY = CONFIG_ASPEED_FB_HEIGHT;
+	pGD->plnSizeX = pGD->winSizeX;
+	pGD->plnSizeY = pGD->winSizeY;
+	pGD->gdfBytesPP = FB_BPP;
+	pGD->gdfIndex = GDF_32BIT_X888RGB;
+	pGD->memSize = FB_PITCH * pGD->winSizeY;
+	sprintf(pGD->modeIdent, "%ux%ux32 CRT", pGD->winSizeX, pGD->winSizeY);
+
+	CheckOnStartClient();
+	if (!ASTSetModeV(0, CRT_1, pGD->frameAdrs, pGD->winSizeX,
+			 pGD->winSizeY, RGB_888, 0)) {
+		printf("Video: no timing for %ux%u\n", pGD->winSizeX,
+		       pGD->winSizeY);
+		return NULL;
+	}
+
+	writel(AST2D_CMDQ_MMIO, AST2D_CMDQ_SET);
+	ast2d_ok = 1;
+	/* clearing the screen doubles as an engine self-test */
+	video_hw_rectfill(FB_BPP, 0, 0, pGD->winSizeX, pGD->winSizeY, 0);
+
+	return pGD;
+}
+
+#endif /* CONFIG_VIDEO_AST2050 */
@@ -179,6 +179,9 @@ int CodecTest(void)
 	    ulTemp = rand();
 	}
     }
+    /* the pattern must reach DRAM before the engine fetches it */
+    flush_dcache_range(g_CAPTURE_VIDEO1_BUF1_ADDR,
+                       g_CAPTURE_VIDEO1_BUF1_ADDR + ALIGN(g_DefWidth*g_DefHeight*4, ARCH_DMA_MINALIGN));
 
     /* init encoder engine */
     InitializeVideoEngineHost (0,
@@ -0,0 +1,252 @@
+/*
+ * Preparing the autoboot kernel while the boot delay counts down
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * The boot delay is otherwise spent polling the console. main_loop()
+ * calls boot_prep_step() between polls instead, so by the time the
+ * countdown runs out the kernel has been verified and unpacked and bootm
+ * only has to jump to it. Each step is small enough that a key press is
+ * still seen at once; a key press that stops autoboot cancels it all.
+ */
+
+#include <common.h>
+#include <boot_prep.h>
+#include <malloc.h>
+#include <linux/ctype.h>
+#include <u-boot/zlib.h>
+
+#ifndef CONFIG_SYS_BOOTM_LEN
+#define CONFIG_SYS_BOOTM_LEN	0x800000	/* as in cmd_bootm.c */
+#endif
+
+/* Image data handled by one step: ~1ms of CRC, a few ms of inflate */
+#define PREP_CHUNK	(16 << 10)
+
+enum prep_stage {
+	PREP_IDLE,
+	PREP_VERIFY,		/* data CRC */
+	PREP_LOAD,		/* copy or inflate to the load address */
+	PREP_DONE,
+	PREP_FAILED,
+};
+
+static struct {
+	enum prep_stage stage;
+	const image_header_t *hdr;
+	image_header_t hdr_copy;	/* to notice the image changing */
+	int verified;
+	ulong pos;			/* bytes of data done in this stage */
+	u32 crc;
+	z_stream zs;
+	int inflating;
+	ulong load_end;
+} prep;
+
+static void prep_fail(const char *why)
+{
+	debug("boot_prep: %s\n", why);
+	boot_prep_cancel();
+	prep.stage = PREP_FAILED;
+}
+
+static void prep_load_begin(void)
+{
+	const uchar *data = (const uchar *)image_get_data(prep.hdr);
+	ulong len = image_get_data_size(&prep.hdr_copy);
+	int offset;
+
+	prep.stage = PREP_LOAD;
+	prep.pos = 0;
+	if (image_get_comp(&prep.hdr_copy) != IH_COMP_GZIP)
+		return;
+
+	offset = gzip_parse_header(data, len);
+	if (offset < 0) {
+		prep_fail("bad gzip header");
+		return;
+	}
+	memset(&prep.zs, 0, sizeof(prep.zs));
+	prep.zs.zalloc = gzalloc;
+	prep.zs.zfree = gzfree;
+	if (inflateInit2(&prep.zs, -MAX_WBITS) != Z_OK) {
+		prep_fail("inflateInit2");
+		return;
+	}
+	prep.inflating = 1;
+	prep.zs.next_in = (uchar *)data + offset;
+	prep.zs.next_out = (uchar *)image_get_load(&prep.hdr_copy);
+	prep.zs.avail_out = CONFIG_SYS_BOOTM_LEN;
+	prep.pos = offset;
+}
+
+static void prep_done(ulong load_end)
+{
+	ulong load = image_get_load(&prep.hdr_copy);
+
+	if (prep.inflating) {
+		inflateEnd(&prep.zs);
+		prep.inflating = 0;
+	}
+	flush_cache(load, load_end - load);
+	prep.load_end = load_end;
+	prep.stage = PREP_DONE;
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "boot_prep");
+}
+
+int boot_prep_step(void)
+{
+	const uchar *data;
+	ulong len, load, n;
+	int ret;
+
+	if (prep.stage != PREP_VERIFY && prep.stage != PREP_LOAD)
+		return 0;
+
+	data = (const uchar *)image_get_data(prep.hdr);
+	len = image_get_data_size(&prep.hdr_copy);
+	load = image_get_load(&prep.hdr_copy);
+	n = min(len - prep.pos, (ulong)PREP_CHUNK);
+
+	if (prep.stage == PREP_VERIFY) {
+		prep.crc = crc32(prep.crc, data + prep.pos, n);
+		prep.pos += n;
+		if (prep.pos < len)
+			return 1;
+		if (prep.crc != image_get_dcrc(&prep.hdr_copy))
+			prep_fail("bad data CRC");
+		else
+			prep_load_begin();
+		return 1;
+	}
+
+	if (!prep.inflating) {
+		memcpy((void *)load + prep.pos, data + prep.pos, n);
+		prep.pos += n;
+		if (prep.pos == len)
+			prep_done(load + len);
+		return 1;
+	}
+
+	prep.zs.avail_in += n;
+	prep.pos += n;
+	ret = inflate(&prep.zs, Z_NO_FLUSH);
+	if (ret == Z_STREAM_END)
+		prep_done(load + prep.zs.total_out);
+	else if (ret != Z_OK && ret != Z_BUF_ERROR)
+		prep_fail("inflate error");
+	else if (!prep.zs.avail_out)
+		prep_fail("image larger than CONFIG_SYS_BOOTM_LEN");
+	else if (prep.pos == len && !prep.zs.avail_in)
+		prep_fail("gzip data truncated");
+
+	return 1;
+}
+
+int boot_prep_start(ulong img_addr)
+{
+	const image_header_t *hdr = map_sysmem(img_addr, 0);
+	ulong data, size, load, end;
+	uint8_t comp;
+
+	boot_prep_cancel();
+	if (!image_check_magic(hdr) || !image_check_hcrc(hdr) ||
+	    image_get_type(hdr) != IH_TYPE_KERNEL ||
+	    !image_check_target_arch(hdr))
+		return -EINVAL;
+
+	comp = image_get_comp(hdr);
+	if (comp != IH_COMP_NONE && comp != IH_COMP_GZIP)
+		return -EOPNOTSUPP;
+
+	data = image_get_data(hdr);
+	size = image_get_data_size(hdr);
+	load = image_get_load(hdr);
+	end = load + (comp == IH_COMP_NONE ? size : CONFIG_SYS_BOOTM_LEN);
+
+	/* XIP, or unpacking over the image itself: bootm sorts those out */
+	if (load < data + size && end > img_addr)
+		return -EINVAL;
+
+	prep.hdr = hdr;
+	memcpy(&prep.hdr_copy, hdr, sizeof(*hdr));
+	prep.verified = getenv_yesno("verify") != 0;	/* as bootm */
+	if (prep.verified) {
+		prep.stage = PREP_VERIFY;
+		prep.pos = 0;
+		prep.crc = 0;
+	} else {
+		prep_load_begin();
+	}
+	debug("boot_prep: image at %08lx, %s\n", img_addr,
+	      prep.verified ? "verifying" : "loading");
+
+	return prep.stage == PREP_FAILED ? -EINVAL : 0;
+}
+
+int boot_prep_cmd(const char *cmd)
+{
+	const char *p = cmd + 5;
+	char *end;
+	ulong addr = load_addr;
+
+	if (strncmp(cmd, "bootm", 5) || (*p && !isblank(*p)))
+		return -EINVAL;
+	while (isblank(*p))
+		p++;
+	if (*p) {
+		addr = simple_strtoul(p, &end, 16);
+		/* a FIT or a command list needs the whole of bootm */
+		if (end == p || (*end && !isblank(*end)))
+			return -EINVAL;
+	}
+	if (strchr(p, ';'))
+		return -EINVAL;
+
+	return boot_prep_start(addr);
+}
+
+int boot_prep_finish(const image_header_t *hdr, ulong *load_end)
+{
+	if (prep.stage == PREP_IDLE || hdr != prep.hdr ||
+	    memcmp(hdr, &prep.hdr_copy, sizeof(*hdr)))
+		return -ENOENT;
+
+	while (boot_prep_step())
+		;
+	if (prep.stage != PREP_DONE)
+		return -EIO;
+	if (load_end)
+		*load_end = prep.load_end;
+
+	return 0;
+}
+
+int boot_prep_verified(const image_header_t *hdr)
+{
+	return !boot_prep_finish(hdr, NULL) && prep.verified;
+}
+
+void boot_prep_cancel(void)
+{
+	if (prep.inflating) {
+		inflateEnd(&prep.zs);
+		prep.inflating = 0;
+	}
+	prep.stage = PREP_IDLE;
+}
@@ -0,0 +1,77 @@
+/*
+ * AES encryption and decryption of memory
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#include <common.h>
+#include <command.h>
+#include <aes.h>
+
+static int do_aes(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	enum aes_mode mode = AES_MODE_CBC;
+	const char *suffix;
+	ulong key, iv, src, dst, len;
+	int encrypt, ret;
+
+	if (argc != 7)
+		return CMD_RET_USAGE;
+
+	/* aes[.ecb|.cbc|.ctr], CBC by default */
+	suffix = strchr(argv[0], '.');
+	if (suffix) {
+		if (!strcmp(suffix, ".ecb"))
+			mode = AES_MODE_ECB;
+		else if (!strcmp(suffix, ".ctr"))
+			mode = AES_MODE_CTR;
+		else if (strcmp(suffix, ".cbc"))
+			return CMD_RET_USAGE;
+	}
+
+	if (!strcmp(argv[1], "enc"))
+		encrypt = 1;
+	else if (!strcmp(argv[1], "dec"))
+		encrypt = 0;
+	else
+		return CMD_RET_USAGE;
+
+	key = simple_strtoul(argv[2], NULL, 16);
+	iv = simple_strtoul(argv[3], NULL, 16);
+	src = simple_strtoul(argv[4], NULL, 16);
+	dst = simple_strtoul(argv[5], NULL, 16);
+	len = simple_strtoul(argv[6], NULL, 16);
+
+	ret = hw_aes_crypt(mode, encrypt, (u8 *)key, (u8 *)iv,
+			   (void *)src, (void *)dst, len);
+	if (ret) {
+		printf("aes: failed (%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	aes,	7,	0,	do_aes,
+	"AES-128 encrypt or decrypt memory",
+	"enc|dec key iv src dst len\n"
+	"    - encrypt or decrypt len bytes from src to dst in CBC mode,\n"
+	"      with the 16 byte key and iv read from memory at key and iv\n"
+	"aes.ecb enc|dec key iv src dst len\n"
+	"aes.ctr enc|dec key iv src dst len\n"
+	"    - the same in ECB (iv ignored) or CTR mode"
+);
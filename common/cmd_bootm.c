@@ -28,6 +28,8 @@
 #include <common.h>
 #include <watchdog.h>
 #include <command.h>
+#include <boot_prep.h>
+#include <lazy_init.h>
 #include <image.h>
 #include <malloc.h>
 #include <u-boot/zlib.h>
@@ -384,6 +386,16 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 
 	const char *type_name = genimg_get_type_name(os.type);
 
+#ifdef CONFIG_BOOT_PREPARE
+	/* unpacked during the boot delay; it is ours now */
+	if (images->legacy_hdr_valid &&
+	    !boot_prep_finish(images->legacy_hdr_os, load_end)) {
+		boot_prep_cancel();
+		printf("   %s prepared during boot delay ... ", type_name);
+		goto loaded;
+	}
+#endif
+
 	load_buf = map_sysmem(load, image_len);
 	image_buf = map_sysmem(image_start, image_len);
 	switch (comp) {
@@ -475,6 +487,9 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 
 	flush_cache(load, (*load_end - load) * sizeof(ulong));
 
+#ifdef CONFIG_BOOT_PREPARE
+loaded:
+#endif
 	puts("OK\n");
 	debug("   kernel loaded at 0x%08lx, end = 0x%08lx\n", load, *load_end);
 	bootstage_mark(BOOTSTAGE_ID_KERNEL_LOADED);
@@ -864,6 +879,12 @@ static image_header_t *image_get_kernel(ulong img_addr, int verify)
 	bootstage_mark(BOOTSTAGE_ID_CHECK_CHECKSUM);
 	image_print_contents(hdr);
 
+#ifdef CONFIG_BOOT_PREPARE
+	if (verify && boot_prep_verified(hdr)) {
+		puts("   Checksum verified during boot delay\n");
+		verify = 0;
+	}
+#endif
 	if (verify) {
 		puts("   Verifying Checksum ... ");
 		if (!image_check_dcrc(hdr)) {
@@ -1176,6 +1197,8 @@ static int do_imls_nor(void)
 	int i, j;
 	void *hdr;
 
+	lazy_init("flash");
+
 	for (i = 0, info = &flash_info[0];
 		i < CONFIG_SYS_MAX_FLASH_BANKS; ++i, ++info) {
 
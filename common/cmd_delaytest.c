@@ -0,0 +1,150 @@
+/*
+ * Delay calibration self-test
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Run udelay() and ndelay() over a range of lengths, measure them with
+ * timer_get_us() and report the error against the requested delay. A
+ * delay that returns early fails the test, and so does one that runs
+ * over by more than the tolerance: CONFIG_DELAYTEST_TOLERANCE percent of
+ * the delay, plus two timebase ticks (the rounding up and the phase of
+ * the first reading), plus CONFIG_DELAYTEST_SLACK_NS for the call and
+ * loop around each delay. A delay shorter than a timebase tick is rounded
+ * up to a whole tick, so at least that is expected of it; only when the
+ * tick is coarser than a microsecond is it skipped.
+ */
+
+#include <common.h>
+#include <command.h>
+
+#ifndef CONFIG_DELAYTEST_TOLERANCE
+#define CONFIG_DELAYTEST_TOLERANCE	10	/* percent */
+#endif
+
+#ifndef CONFIG_DELAYTEST_SLACK_NS
+#define CONFIG_DELAYTEST_SLACK_NS	2000
+#endif
+
+static const unsigned long test_usec[] = { 1, 10, 100, 1000, 10000, 100000 };
+static const unsigned long test_nsec[] = { 100, 500 };
+
+/* Keep each measurement around 100ms so the test finishes quickly */
+static int loops_for(unsigned long nsec)
+{
+	unsigned long loops = 100000000 / nsec;
+
+	return loops ? (loops > 1000 ? 1000 : loops) : 1;
+}
+
+/* Length of a timebase tick, rounded up */
+static unsigned long tick_ns(void)
+{
+	return DIV_ROUND_UP(1000000000UL, get_tbclk());
+}
+
+/* Shortest time a delay may take: at least one whole timebase tick */
+static unsigned long min_for(unsigned long want_ns)
+{
+	return want_ns < tick_ns() ? tick_ns() : want_ns;
+}
+
+/* Print one result line and return non-zero if the delay was out of range */
+static int report(unsigned long want_ns, ulong total_us, int loops)
+{
+	unsigned long got_ns = total_us * 1000 / loops;
+	unsigned long min_ns = min_for(want_ns);
+	unsigned long max_ns = min_ns + min_ns / 100 *
+			       CONFIG_DELAYTEST_TOLERANCE + 2 * tick_ns() +
+			       CONFIG_DELAYTEST_SLACK_NS;
+	long err_ns = got_ns - want_ns;
+	int fail = got_ns < min_ns || got_ns > max_ns;
+
+	printf("%9lu ns %6d %11lu ns %+10ld ns %+6ld%% %11lu ns  %s\n",
+	       want_ns, loops, got_ns, err_ns, err_ns * 100 / (long)want_ns,
+	       max_ns, got_ns < min_ns ? "SHORT" :
+	       got_ns > max_ns ? "LONG" :
+	       min_ns != want_ns ? "ok, one tick" : "ok");
+
+	return fail;
+}
+
+/*
+ * Say so and return non-zero if the timebase is too coarse for a delay:
+ * one rounded up to a whole tick longer than a microsecond can't be told
+ * from the call around it.
+ */
+static int skip(unsigned long want_ns)
+{
+	if (want_ns >= tick_ns() || tick_ns() <= 1000)
+		return 0;
+	printf("%9lu ns %6s %11s    %10s    %6s  %11s     skipped\n", want_ns,
+	       "-", "-", "-", "-", "-");
+
+	return 1;
+}
+
+static int do_delaytest(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	ulong start;
+	int i, loops, n;
+	int fail = 0, tested = 0;
+
+	printf("timebase %lu Hz, tolerance %d%% + 2 ticks + %d ns\n",
+	       get_tbclk(), CONFIG_DELAYTEST_TOLERANCE,
+	       CONFIG_DELAYTEST_SLACK_NS);
+	printf("%12s %6s %14s %13s %7s %14s\n", "delay", "loops", "average",
+	       "error", "", "limit");
+
+	for (i = 0; i < ARRAY_SIZE(test_usec); i++) {
+		if (skip(test_usec[i] * 1000))
+			continue;
+		loops = loops_for(test_usec[i] * 1000);
+		start = timer_get_us();
+		for (n = 0; n < loops; n++)
+			udelay(test_usec[i]);
+		fail |= report(test_usec[i] * 1000, timer_get_us() - start,
+			       loops);
+		tested++;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(test_nsec); i++) {
+		if (skip(test_nsec[i]))
+			continue;
+		loops = loops_for(test_nsec[i]);
+		start = timer_get_us();
+		for (n = 0; n < loops; n++)
+			ndelay(test_nsec[i]);
+		fail |= report(test_nsec[i], timer_get_us() - start, loops);
+		tested++;
+	}
+
+	if (!tested) {
+		puts("SKIPPED: timebase too coarse for any delay\n");
+		return CMD_RET_FAILURE;
+	}
+	puts(fail ? "FAILED: delay out of range\n" : "OK\n");
+
+	return fail ? CMD_RET_FAILURE : 0;
+}
+
+U_BOOT_CMD(
+	delaytest,	1,	0,	do_delaytest,
+	"measure udelay()/ndelay() accuracy",
+	""
+);
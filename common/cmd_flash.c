@@ -26,6 +26,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <lazy_init.h>
 
 #ifdef CONFIG_HAS_DATAFLASH
 #include <dataflash.h>
@@ -300,6 +301,8 @@ static int do_flinfo(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 #endif
 
 #ifndef CONFIG_SYS_NO_FLASH
+	lazy_init("flash");
+
 	if (argc == 1) {	/* print info for all FLASH banks */
 		for (bank=0; bank <CONFIG_SYS_MAX_FLASH_BANKS; ++bank) {
 			printf ("\nBank # %ld: ", bank+1);
@@ -337,6 +340,8 @@ static int do_flerase(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	if (argc < 2)
 		return CMD_RET_USAGE;
 
+	lazy_init("flash");
+
 	if (strcmp(argv[1], "all") == 0) {
 		for (bank=1; bank<=CONFIG_SYS_MAX_FLASH_BANKS; ++bank) {
 			printf ("Erase Flash Bank # %ld ", bank);
@@ -424,6 +429,8 @@ int flash_sect_erase (ulong addr_first, ulong addr_last)
 	int planned;
 	int rcode = 0;
 
+	lazy_init("flash");
+
 	rcode = flash_fill_sect_ranges (addr_first, addr_last,
 					s_first, s_last, &planned );
 
@@ -478,6 +485,10 @@ static int do_protect(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	if (argc < 3)
 		return CMD_RET_USAGE;
 
+#ifndef CONFIG_SYS_NO_FLASH
+	lazy_init("flash");
+#endif
+
 #if !defined(CONFIG_SYS_NO_FLASH) || defined(CONFIG_HAS_DATAFLASH)
 	if (strcmp(argv[1], "off") == 0)
 		p = 0;
@@ -641,6 +652,8 @@ int flash_sect_protect (int p, ulong addr_first, ulong addr_last)
 	int planned;
 	int rcode;
 
+	lazy_init("flash");
+
 	rcode = flash_fill_sect_ranges( addr_first, addr_last, s_first, s_last, &planned );
 
 	protected = 0;
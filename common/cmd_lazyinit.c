@@ -0,0 +1,53 @@
+/*
+ * Report on, or force, the subsystems left for first use
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#include <common.h>
+#include <command.h>
+#include <lazy_init.h>
+
+static int do_lazyinit(cmd_tbl_t *cmdtp, int flag, int argc,
+		       char * const argv[])
+{
+	int i, ret = 0;
+
+	if (argc < 2) {
+		lazy_init_report();
+		return 0;
+	}
+
+	for (i = 1; i < argc; i++) {
+		if (!lazy_init_find(argv[i])) {
+			printf("%s: no such subsystem\n", argv[i]);
+			ret = CMD_RET_FAILURE;
+		} else if (lazy_init(argv[i])) {
+			ret = CMD_RET_FAILURE;
+		}
+	}
+
+	return ret;
+}
+
+U_BOOT_CMD(
+	lazyinit,	CONFIG_SYS_MAXARGS,	0,	do_lazyinit,
+	"subsystems initialised on first use",
+	"\n"
+	"    - show which have been initialised, and how long it took\n"
+	"lazyinit name ...\n"
+	"    - initialise them now"
+);
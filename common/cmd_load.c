@@ -34,7 +34,7 @@
 DECLARE_GLOBAL_DATA_PTR;
 
 #if defined(CONFIG_CMD_LOADB)
-static ulong load_serial_ymodem(ulong offset);
+static ulong load_serial_ymodem(ulong offset, int mode);
 #endif
 
 #if defined(CONFIG_CMD_LOADS)
@@ -472,13 +472,17 @@ static int do_load_serial_bin(cmd_tbl_t *cmdtp, int flag, int argc,
 		}
 	}
 
-	if (strcmp(argv[0],"loady")==0) {
-		printf("## Ready for binary (ymodem) download "
+	if (strncmp(argv[0], "loady", 5) == 0) {
+		int mode = argv[0][5] == 'g' ? xyzModem_ymodem_g :
+					       xyzModem_ymodem;
+
+		printf("## Ready for binary (%s) download "
 			"to 0x%08lX at %d bps...\n",
+			mode == xyzModem_ymodem_g ? "ymodem-g" : "ymodem",
 			offset,
 			load_baudrate);
 
-		addr = load_serial_ymodem(offset);
+		addr = load_serial_ymodem(offset, mode);
 
 	} else {
 
@@ -958,18 +962,30 @@ static int getcxmodem(void) {
 		return (getc());
 	return -1;
 }
-static ulong load_serial_ymodem(ulong offset)
+static ulong load_serial_ymodem(ulong offset, int mode)
 {
 	int size;
-	int err;
+	int err = 0;
 	int res;
+	bool abort = false;
 	connection_info_t info;
 	char ymodemBuf[1024];
 	ulong store_addr = ~0;
 	ulong addr = 0;
 
+#ifndef CONFIG_SYS_NO_FLASH
+	/*
+	 * A streaming sender does not wait for us, and nothing drains the
+	 * UART while flash is being programmed.
+	 */
+	if (mode == xyzModem_ymodem_g && addr2info(offset)) {
+		puts("## ymodem-g can't load into flash, load to RAM first\n");
+		return ~0;
+	}
+#endif
+
 	size = 0;
-	info.mode = xyzModem_ymodem;
+	info.mode = mode;
 	res = xyzModem_stream_open(&info, &err);
 	if (!res) {
 
@@ -996,12 +1012,16 @@ static ulong load_serial_ymodem(ulong offset)
 			}
 
 		}
+		/* a transfer that broke off must be cancelled at the sender */
+		abort = err && err != xyzModem_eof;
+		if (abort)
+			printf("%s\n", xyzModem_error(err));
 	} else {
 		printf("%s\n", xyzModem_error(err));
 	}
 
 	xyzModem_stream_close(&err);
-	xyzModem_stream_terminate(false, &getcxmodem);
+	xyzModem_stream_terminate(abort, &getcxmodem);
 
 
 	flush_cache(offset, size);
@@ -1079,6 +1099,14 @@ U_BOOT_CMD(
 	" with offset 'off' and baudrate 'baud'"
 );
 
+U_BOOT_CMD(
+	loadyg, 3, 0,	do_load_serial_bin,
+	"load binary file over serial line (ymodem-g mode)",
+	"[ off ] [ baud ]\n"
+	"    - load binary file into RAM over serial line, streaming"
+	" with no ACK per block, with offset 'off' and baudrate 'baud'"
+);
+
 #endif	/* CONFIG_CMD_LOADB */
 
 /* -------------------------------------------------------------------- */
@@ -29,9 +29,11 @@
 
 #include <common.h>
 #include <command.h>
+#include <div64.h>
 #ifdef CONFIG_HAS_DATAFLASH
 #include <dataflash.h>
 #endif
+#include <errno.h>
 #include <hash.h>
 #include <watchdog.h>
 #include <asm/io.h>
@@ -634,11 +636,22 @@ int do_mem_loopw (cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 #endif /* CONFIG_LOOPW */
 
 #ifdef CONFIG_CMD_MEMTEST
+__weak int mem_test_hw(ulong start_addr, ulong end_addr, ulong pattern,
+		       ulong *errs)
+{
+	return -ENOSYS;
+}
+
+__weak int mem_test_check(ulong start_addr, ulong end_addr)
+{
+	return 0;
+}
+
 static ulong mem_test_alt(vu_long *buf, ulong start_addr, ulong end_addr,
 			  vu_long *dummy)
 {
 	vu_long *addr;
-	ulong errs = 0;
+	ulong errs = 0, hw_errs;
 	ulong val, readback;
 	int j;
 	vu_long offset;
@@ -804,6 +817,10 @@ static ulong mem_test_alt(vu_long *buf, ulong start_addr, ulong end_addr,
 	 *
 	 * Returns:     0 if the test succeeds, 1 if the test fails.
 	 */
+	if (!mem_test_hw(start_addr, end_addr + sizeof(vu_long), 1,
+			 &hw_errs))
+		return hw_errs == -1UL ? -1UL : errs + hw_errs;
+
 	num_words++;
 
 	/*
@@ -878,6 +895,9 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 		else
 			pattern = ~pattern;
 	}
+	if (!mem_test_hw(start_addr, end_addr, pattern, &errs))
+		return errs;
+
 	length = (end_addr - start_addr) / sizeof(ulong);
 	end = buf + length;
 	printf("\rPattern %08lX  Writing..."
@@ -913,6 +933,169 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 	return 0;
 }
 
+/*
+ * March tests. Each element walks every word up or down the range, reads
+ * and checks it against the background (or its complement), then writes
+ * the background (or its complement). Several data backgrounds are run in
+ * turn; the final read-only element of one is folded into the fill of the
+ * next, so each background costs one pass less.
+ */
+#define MARCH_NONE		0
+#define MARCH_0			1	/* the background */
+#define MARCH_1			2	/* its complement */
+
+/* Errors printed in full; the rest only show up in the summary */
+#define MEM_TEST_MAX_REPORT	16
+#define MEM_TEST_MAP_BITS	32
+
+struct march_element {
+	u8 down;
+	u8 read;
+	u8 write;
+};
+
+struct mem_test_alg {
+	const char *name;
+	const struct march_element *elem;	/* NULL for alt/quick */
+	int nelem;
+};
+
+struct mem_test_stats {
+	ulong errs;
+	ulong bits;		/* every data bit that ever failed */
+	u32 map;		/* regions of the range that failed */
+	unsigned long long bytes;
+};
+
+/* March C-: {any(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); any(r0)} */
+static const struct march_element march_c_minus[] = {
+	{ 0, MARCH_NONE, MARCH_0 },
+	{ 0, MARCH_0, MARCH_1 },
+	{ 0, MARCH_1, MARCH_0 },
+	{ 1, MARCH_0, MARCH_1 },
+	{ 1, MARCH_1, MARCH_0 },
+	{ 0, MARCH_0, MARCH_NONE },
+};
+
+/* MATS+: {any(w0); up(r0,w1); down(r1,w0)} */
+static const struct march_element march_mats_plus[] = {
+	{ 0, MARCH_NONE, MARCH_0 },
+	{ 0, MARCH_0, MARCH_1 },
+	{ 1, MARCH_1, MARCH_0 },
+};
+
+static const struct mem_test_alg mem_test_algs[] = {
+	{ "quick" },
+	{ "alt" },
+	{ "marchc", march_c_minus, ARRAY_SIZE(march_c_minus) },
+	{ "mats", march_mats_plus, ARRAY_SIZE(march_mats_plus) },
+};
+
+/* Repeat a 32-bit background across a long, so ~bg complements every bit */
+#define MARCH_BG(x)		((ulong)(x) * (~0UL / 0xffffffffUL))
+
+static const ulong march_backgrounds[] = {
+	MARCH_BG(0x00000000), MARCH_BG(0x55555555), MARCH_BG(0x33333333),
+	MARCH_BG(0x0f0f0f0f), MARCH_BG(0x00ff00ff), MARCH_BG(0x0000ffff),
+};
+
+static int march_fail(struct mem_test_stats *st, ulong start_addr,
+		      ulong offset, ulong words, ulong expect, ulong actual)
+{
+	ulong region = words / MEM_TEST_MAP_BITS + 1;
+
+	if (st->errs < MEM_TEST_MAX_REPORT)
+		printf("\nMem error @ 0x%08lx: found %08lx, expected %08lx\n",
+		       start_addr + offset * sizeof(ulong), actual, expect);
+	st->errs++;
+	st->bits |= expect ^ actual;
+	st->map |= 1 << (offset / region);
+
+	return ctrlc() ? -1 : 0;
+}
+
+static int march_element(vu_long *buf, ulong start_addr, ulong words,
+			 const struct march_element *e, ulong bg, ulong fill,
+			 struct mem_test_stats *st)
+{
+	ulong expect = e->read == MARCH_1 ? ~bg : bg;
+	ulong val = e->write == MARCH_1 ? ~bg : bg;
+	ulong n, offset, readback;
+
+	if (e->read == MARCH_NONE && e->write == MARCH_0 &&
+	    fill == ~0UL / 0xff * (fill & 0xff)) {
+		/* a uniform fill is memset's job */
+		memset((void *)buf, fill & 0xff, words * sizeof(ulong));
+		st->bytes += words * sizeof(ulong);
+		return 0;
+	}
+	if (e->write == MARCH_0)
+		val = fill;
+
+	for (n = 0; n < words; n++) {
+		offset = e->down ? words - 1 - n : n;
+		if (!(n & 0xffff))
+			WATCHDOG_RESET();
+		if (e->read != MARCH_NONE) {
+			readback = buf[offset];
+			if (readback != expect &&
+			    march_fail(st, start_addr, offset, words, expect,
+				       readback))
+				return -1;
+		}
+		if (e->write != MARCH_NONE)
+			buf[offset] = val;
+	}
+	st->bytes += words * sizeof(ulong) *
+		((e->read != MARCH_NONE) + (e->write != MARCH_NONE));
+
+	return 0;
+}
+
+static ulong mem_test_march(vu_long *buf, ulong start_addr, ulong end_addr,
+			    const struct mem_test_alg *alg, ulong pattern,
+			    struct mem_test_stats *st)
+{
+	const ulong *bgs = march_backgrounds;
+	int nbg = ARRAY_SIZE(march_backgrounds);
+	const struct march_element *last = &alg->elem[alg->nelem - 1];
+	ulong words = (end_addr - start_addr) / sizeof(ulong);
+	ulong errs = st->errs;
+	ulong fill;
+	int b, i, fused = 0;
+
+	if (pattern) {
+		bgs = &pattern;
+		nbg = 1;
+	}
+
+	for (b = 0; b < nbg; b++) {
+		printf("\rBackground %08lX  %s...%12s\b\b\b\b\b\b\b\b\b\b\b\b",
+		       bgs[b], alg->name, "");
+		for (i = fused; i < alg->nelem; i++) {
+			fill = bgs[b];
+			/* leave the next background behind on the way out */
+			fused = &alg->elem[i] == last && b + 1 < nbg &&
+				last->write == MARCH_NONE;
+			if (fused) {
+				struct march_element e = *last;
+
+				e.write = MARCH_0;
+				fill = bgs[b + 1];
+				if (march_element(buf, start_addr, words, &e,
+						  bgs[b], fill, st))
+					return -1;
+				break;
+			}
+			if (march_element(buf, start_addr, words,
+					  &alg->elem[i], bgs[b], fill, st))
+				return -1;
+		}
+	}
+
+	return st->errs - errs;
+}
+
 /*
  * Perform a memory test. A more complete alternative test can be
  * configured using CONFIG_SYS_ALT_MEMTEST. The complete test loops until
@@ -929,10 +1112,22 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 	ulong pattern;
 	int iteration;
 #if defined(CONFIG_SYS_ALT_MEMTEST)
-	const int alt_test = 1;
+	const struct mem_test_alg *alg = &mem_test_algs[1];
 #else
-	const int alt_test = 0;
+	const struct mem_test_alg *alg = &mem_test_algs[0];
 #endif
+	struct mem_test_stats st;
+	ulong start_time, ms;
+	int i;
+
+	for (i = 0; argc > 1 && i < ARRAY_SIZE(mem_test_algs); i++) {
+		if (!strcmp(argv[1], mem_test_algs[i].name)) {
+			alg = &mem_test_algs[i];
+			argc--;
+			argv++;
+			break;
+		}
+	}
 
 	if (argc > 1)
 		start = simple_strtoul(argv[1], NULL, 16);
@@ -954,12 +1149,20 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 	else
 		iteration_limit = 0;
 
+	if (mem_test_check(start, end)) {
+		printf("Refusing to test %08x ... %08x, U-Boot is using it\n",
+		       (uint)start, (uint)end);
+		return 1;
+	}
+
 	printf("Testing %08x ... %08x:\n", (uint)start, (uint)end);
 	debug("%s:%d: start %#08lx end %#08lx\n", __func__, __LINE__,
 	      start, end);
 
 	buf = map_sysmem(start, end - start);
 	dummy = map_sysmem(CONFIG_SYS_MEMTEST_SCRATCH, sizeof(vu_long));
+	memset(&st, 0, sizeof(st));
+	start_time = get_timer(0);
 	for (iteration = 0;
 			!iteration_limit || iteration < iteration_limit;
 			iteration++) {
@@ -970,7 +1173,10 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 
 		printf("Iteration: %6d\r", iteration + 1);
 		debug("\n");
-		if (alt_test) {
+		if (alg->elem) {
+			errs = mem_test_march(buf, start, end, alg, pattern,
+					      &st);
+		} else if (alg == &mem_test_algs[1]) {
 			errs = mem_test_alt(buf, start, end, dummy);
 		} else {
 			errs = mem_test_quick(buf, start, end, pattern,
@@ -998,11 +1204,26 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 		putc('\n');
 		ret = 1;
 	} else {
+		if (alg->elem)
+			errs = st.errs;
 		printf("Tested %d iteration(s) with %lu errors.\n",
 			iteration, errs);
 		ret = errs != 0;
 	}
 
+	if (alg->elem) {
+		ms = max(get_timer(start_time), 1UL);
+		printf("%llu MiB tested at %llu MB/s\n", st.bytes >> 20,
+		       lldiv(st.bytes, ms * 1000));
+	}
+	if (st.errs) {
+		printf("Failing bits %08lx, failing 1/%ds of the range: ",
+		       st.bits, MEM_TEST_MAP_BITS);
+		for (i = 0; i < MEM_TEST_MAP_BITS; i++)
+			putc(st.map & (1 << i) ? 'X' : '.');
+		putc('\n');
+	}
+
 	return ret;	/* not reached */
 }
 #endif	/* CONFIG_CMD_MEMTEST */
@@ -1245,9 +1466,11 @@ U_BOOT_CMD(
 
 #ifdef CONFIG_CMD_MEMTEST
 U_BOOT_CMD(
-	mtest,	5,	1,	do_mem_mtest,
+	mtest,	6,	1,	do_mem_mtest,
 	"simple RAM read/write test",
-	"[start [end [pattern [iterations]]]]"
+	"[alg] [start [end [pattern [iterations]]]]\n"
+	"    - alg is quick, alt, marchc (March C-) or mats (MATS+);\n"
+	"      the march tests use pattern as their only data background"
 );
 #endif	/* CONFIG_CMD_MEMTEST */
 
@@ -27,6 +27,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <lazy_init.h>
 #include <miiphy.h>
 
 typedef struct _MII_reg_desc_t {
@@ -295,6 +296,9 @@ static int do_mii(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	if (argc < 2)
 		return CMD_RET_USAGE;
 
+	/* the PHYs are registered by the MAC drivers */
+	lazy_init("eth");
+
 #if defined(CONFIG_MII_INIT)
 	mii_init ();
 #endif
@@ -0,0 +1,58 @@
+/*
+ * Sampling profiler commands
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#include <common.h>
+#include <command.h>
+#include <profile.h>
+
+static int do_profile(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char * const argv[])
+{
+	const char *cmd = argc < 2 ? "" : argv[1];
+	int ret;
+
+	if (!strcmp(cmd, "start")) {
+		ret = profile_start(argc > 2 ?
+				    simple_strtoul(argv[2], NULL, 10) : 0);
+		if (ret) {
+			printf("Cannot start profiling (err=%d)\n", ret);
+			return CMD_RET_FAILURE;
+		}
+	} else if (!strcmp(cmd, "stop")) {
+		profile_stop();
+	} else if (!strcmp(cmd, "clear")) {
+		profile_clear();
+	} else if (!strcmp(cmd, "report")) {
+		profile_report(argc > 2 ?
+			       simple_strtoul(argv[2], NULL, 10) : 20);
+	} else {
+		return CMD_RET_USAGE;
+	}
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	profile,	3,	1,	do_profile,
+	"sampling profiler",
+	"start [<hz>]     - start taking samples\n"
+	"profile stop             - stop taking samples\n"
+	"profile clear            - throw away the samples taken\n"
+	"profile report [<count>] - list the functions with most samples"
+);
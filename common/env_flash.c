@@ -29,6 +29,7 @@
 #include <common.h>
 #include <command.h>
 #include <environment.h>
+#include <env_index.h>
 #include <linux/stddef.h>
 #include <malloc.h>
 #include <search.h>
@@ -72,6 +73,282 @@ static env_t *flash_addr_new = (env_t *)CONFIG_ENV_ADDR_REDUND;
 static ulong end_addr_new = CONFIG_ENV_ADDR_REDUND + CONFIG_ENV_SECT_SIZE - 1;
 #endif /* CONFIG_ENV_ADDR_REDUND */
 
+#ifdef CONFIG_ENV_LOG
+/*
+ * Saves append to a log in the rest of the sector after the environment:
+ * each record holds the variables which changed since the last save, and
+ * the names of those deleted. Only when the log is full is the whole
+ * environment written out again, which erases the sector and empties the
+ * log. A record is written before its header, so one cut short by a power
+ * failure fails its CRC and is ignored. With CONFIG_ENV_ADDR_REDUND the log
+ * is in the active copy, and the full write goes to the other one, which
+ * becomes active only once it is complete: the copy holding the log is not
+ * erased until the next time the log fills up.
+ */
+#if CONFIG_ENV_SECT_SIZE <= CONFIG_ENV_SIZE
+#error CONFIG_ENV_LOG needs CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#endif
+
+#define ENV_LOG_SIZE	(CONFIG_ENV_SECT_SIZE - CONFIG_ENV_SIZE)
+
+/*
+ * An environment saved before there was a log filled the sector at
+ * CONFIG_ENV_ADDR, with no flags byte. It is still read, from here, and
+ * the next saveenv writes it out as it is now expected.
+ */
+#define ENV_LOG_OLD_DATA	(CONFIG_ENV_ADDR + sizeof(uint32_t))
+#define ENV_LOG_OLD_SIZE	(CONFIG_ENV_SECT_SIZE - sizeof(uint32_t))
+
+struct env_log_rec {
+	uint32_t crc;		/* CRC32 over the rest of the record */
+	uint32_t base_crc;	/* CRC of the environment it applies to */
+	uint32_t len;		/* bytes of data, like the environment's */
+};
+
+static int env_log_old_valid(void)
+{
+	uint32_t crc;
+
+	memcpy(&crc, (void *)CONFIG_ENV_ADDR, sizeof(crc));
+
+	return crc32(0, (uchar *)ENV_LOG_OLD_DATA, ENV_LOG_OLD_SIZE) == crc;
+}
+
+static const uchar *env_log_start(void)
+{
+	return (const uchar *)flash_addr + CONFIG_ENV_SIZE;
+}
+
+/*
+ * Get the record at *offp and move on to the next. Returns its data, or
+ * NULL at the end of the log.
+ */
+static const char *env_log_next(ulong *offp, uint32_t *lenp)
+{
+	const uchar *p = env_log_start() + *offp;
+	struct env_log_rec rec;
+	uint32_t crc;
+
+	if (*offp + sizeof(rec) >= ENV_LOG_SIZE)
+		return NULL;
+	memcpy(&rec, p, sizeof(rec));
+	memcpy(&crc, &flash_addr->crc, sizeof(crc));
+	if (rec.base_crc != crc || !rec.len ||
+	    rec.len > ENV_LOG_SIZE - *offp - sizeof(rec))
+		return NULL;
+	p += sizeof(rec);
+	crc = crc32(0, (uchar *)&rec.base_crc,
+		    sizeof(rec) - offsetof(struct env_log_rec, base_crc));
+	if (crc32(crc, p, rec.len) != rec.crc || p[rec.len - 1])
+		return NULL;
+
+	*offp += ALIGN(sizeof(rec) + rec.len, 4);
+	*lenp = rec.len;
+
+	return (const char *)p;
+}
+
+/* Apply the log to the environment just imported */
+static void env_log_replay(void)
+{
+	const char *data;
+	ulong off = 0;
+	uint32_t len;
+	int count = 0;
+
+	while ((data = env_log_next(&off, &len))) {
+		if (!himport_r(&env_htab, data, len, '\0',
+			       H_NOCLEAR | H_FORCE, 0, NULL))
+			error("Cannot apply environment log: errno = %d\n",
+			      errno);
+		count++;
+	}
+	debug("Applied %d environment log records, %lu bytes\n", count, off);
+}
+
+#ifdef CMD_SAVEENV
+/* Compare variable names in "name=value" or "name" strings */
+static int env_log_keycmp(const char *a, const char *b)
+{
+	while (*a == *b && *a && *a != '=') {
+		a++;
+		b++;
+	}
+
+	return (*a == '=' ? 0 : (uchar)*a) - (*b == '=' ? 0 : (uchar)*b);
+}
+
+static int env_log_cmp(const void *p1, const void *p2)
+{
+	const char *const *v1 = p1, *const *v2 = p2;
+	int ret = env_log_keycmp(*v1, *v2);
+
+	/* later strings are further into the sector, and win */
+	return ret ? ret : (*v1 < *v2 ? -1 : 1);
+}
+
+/*
+ * List the strings of the environment in flash and of its log, as far as
+ * the record at off. Returns how many there are, and fills in vars if not
+ * NULL.
+ */
+static int env_log_vars(const char **vars, ulong off)
+{
+	const char *data, *p;
+	ulong pos = 0;
+	uint32_t len;
+	int count = 0;
+
+	for (p = (const char *)flash_addr->data; *p; p += strlen(p) + 1) {
+		if (vars)
+			vars[count] = p;
+		count++;
+	}
+	while (pos < off && (data = env_log_next(&pos, &len))) {
+		for (p = data; *p; p += strlen(p) + 1) {
+			if (vars)
+				vars[count] = p;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/*
+ * Work out what changed since the environment in flash was saved, with its
+ * log as far as off. Returns the data for a record, or NULL if out of
+ * memory.
+ */
+static char *env_log_diff(ulong off, uint32_t *lenp)
+{
+	const char **vars, *old, *eq;
+	char *cur = NULL, *diff, *p, *q;
+	ssize_t size;
+	int count, i, j, ret;
+
+	size = hexport_r(&env_htab, '\0', 0, &cur, 0, 0, NULL);
+	if (size < 0)
+		return NULL;
+	count = env_log_vars(NULL, off);
+	vars = malloc(count * sizeof(*vars));
+	/* at worst every variable changed and every old one was deleted */
+	diff = malloc(size + CONFIG_ENV_SECT_SIZE);
+	if (!vars || !diff) {
+		free(vars);
+		free(diff);
+		free(cur);
+		return NULL;
+	}
+	env_log_vars(vars, off);
+	qsort(vars, count, sizeof(*vars), env_log_cmp);
+
+	/* Both lists are sorted by name, so step through them together */
+	for (i = 0, q = cur, p = diff; i < count || *q; ) {
+		/* the last string for a name is what flash holds */
+		for (j = i; j + 1 < count &&
+		     !env_log_keycmp(vars[j], vars[j + 1]); j++)
+			;
+		old = i < count ? vars[j] : NULL;
+		if (!old)
+			ret = 1;
+		else if (!*q)
+			ret = -1;
+		else
+			ret = env_log_keycmp(old, q);
+
+		if (ret < 0) {
+			/* gone now: delete it, unless flash has it deleted */
+			eq = strchr(old, '=');
+			if (eq) {
+				memcpy(p, old, eq - old);
+				p += eq - old;
+				*p++ = '\0';
+			}
+		} else if (ret > 0 || !strchr(old, '=') || strcmp(old, q)) {
+			strcpy(p, q);
+			p += strlen(q) + 1;
+		}
+		if (ret <= 0)
+			i = j + 1;
+		if (ret >= 0)
+			q += strlen(q) + 1;
+	}
+	*p++ = '\0';
+	*lenp = p - diff;
+	free(vars);
+	free(cur);
+
+	return diff;
+}
+
+/*
+ * Append what changed to the log. Returns 0 if done, -1 on error, or 1 if
+ * the environment must be written out in full instead.
+ */
+static int env_log_append(void)
+{
+	struct env_log_rec rec;
+	const uchar *log = env_log_start();
+	ulong off = 0, size, i;
+	uint32_t len;
+	char *diff;
+	int rc;
+
+	/* Only on top of an environment which is valid as it is */
+	if (crc32(0, flash_addr->data, ENV_SIZE) != flash_addr->crc)
+		return 1;
+	while (env_log_next(&off, &len))
+		;
+
+	diff = env_log_diff(off, &len);
+	if (!diff)
+		return 1;
+	if (len == 1) {
+		puts("Environment unchanged\n");
+		free(diff);
+		return 0;
+	}
+
+	size = ALIGN(sizeof(rec) + len, 4);
+	for (i = 0; off + size <= ENV_LOG_SIZE && i < size; i++) {
+		if (log[off + i] != 0xff)
+			break;
+	}
+	if (i < size) {
+		debug("Environment log full, writing it all out\n");
+		free(diff);
+		return 1;
+	}
+
+	memcpy(&rec.base_crc, &flash_addr->crc, sizeof(rec.base_crc));
+	rec.len = len;
+	rec.crc = crc32(0, (uchar *)&rec.base_crc,
+			sizeof(rec) - offsetof(struct env_log_rec, base_crc));
+	rec.crc = crc32(rec.crc, (uchar *)diff, len);
+
+	rc = 1;
+	if (flash_sect_protect(0, (ulong)flash_addr, end_addr))
+		goto done;
+	printf("Appending %u bytes to Flash... ", len);
+	rc = flash_write(diff, (ulong)log + off + sizeof(rec), len);
+	if (!rc)
+		rc = flash_write((char *)&rec, (ulong)log + off, sizeof(rec));
+	if (rc) {
+		flash_perror(rc);
+		rc = -1;
+	} else {
+		puts("done\n");
+	}
+done:
+	flash_sect_protect(1, (ulong)flash_addr, end_addr);
+	free(diff);
+
+	return rc;
+}
+#endif /* CMD_SAVEENV */
+#endif /* CONFIG_ENV_LOG */
+
 
 #ifdef CONFIG_ENV_ADDR_REDUND
 int env_init(void)
@@ -95,6 +372,11 @@ int env_init(void)
 	} else if (!crc1_ok && crc2_ok) {
 		gd->env_addr	= addr2;
 		gd->env_valid	= 1;
+#ifdef CONFIG_ENV_LOG
+	} else if (!crc1_ok && !crc2_ok && env_log_old_valid()) {
+		gd->env_addr	= ENV_LOG_OLD_DATA;
+		gd->env_valid	= 2;
+#endif
 	} else if (!crc1_ok && !crc2_ok) {
 		gd->env_addr	= addr_default;
 		gd->env_valid	= 0;
@@ -126,10 +408,16 @@ int saveenv(void)
 	char	*res, *saved_data = NULL;
 	char	flag = OBSOLETE_FLAG, new_flag = ACTIVE_FLAG;
 	int	rc = 1;
-#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE && !defined(CONFIG_ENV_LOG)
 	ulong	up_data = 0;
 #endif
 
+#ifdef CONFIG_ENV_LOG
+	rc = env_log_append();
+	if (rc <= 0)
+		return rc ? 1 : 0;
+	rc = 1;
+#endif
 	debug("Protect off %08lX ... %08lX\n", (ulong)flash_addr, end_addr);
 
 	if (flash_sect_protect(0, (ulong)flash_addr, end_addr))
@@ -147,10 +435,14 @@ int saveenv(void)
 		error("Cannot export environment: errno = %d\n", errno);
 		goto done;
 	}
+#ifdef CONFIG_ENV_INDEX
+	if (env_index_build((char *)env_new.data, ENV_SIZE, env_htab.size))
+		debug("Saving the environment without an index\n");
+#endif
 	env_new.crc	= crc32(0, env_new.data, ENV_SIZE);
 	env_new.flags	= new_flag;
 
-#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE && !defined(CONFIG_ENV_LOG)
 	up_data = end_addr_new + 1 - ((long)flash_addr_new + CONFIG_ENV_SIZE);
 	debug("Data to save 0x%lX\n", up_data);
 	if (up_data) {
@@ -188,7 +480,7 @@ int saveenv(void)
 	if (rc)
 		goto perror;
 
-#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE && !defined(CONFIG_ENV_LOG)
 	if (up_data) { /* restore the rest of sector */
 		debug("Restoring the rest of data to 0x%lX len 0x%lX\n",
 			(long)flash_addr_new + CONFIG_ENV_SIZE, up_data);
@@ -235,6 +527,13 @@ int env_init(void)
 		gd->env_valid	= 1;
 		return 0;
 	}
+#ifdef CONFIG_ENV_LOG
+	if (env_log_old_valid()) {
+		gd->env_addr	= ENV_LOG_OLD_DATA;
+		gd->env_valid	= 2;
+		return 0;
+	}
+#endif
 
 	gd->env_addr	= (ulong)&default_environment[0];
 	gd->env_valid	= 0;
@@ -248,7 +547,13 @@ int saveenv(void)
 	ssize_t	len;
 	int	rc = 1;
 	char	*res, *saved_data = NULL;
-#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#ifdef CONFIG_ENV_LOG
+	rc = env_log_append();
+	if (rc <= 0)
+		return rc ? 1 : 0;
+	rc = 1;
+#endif
+#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE && !defined(CONFIG_ENV_LOG)
 	ulong	up_data = 0;
 
 	up_data = end_addr + 1 - ((long)flash_addr + CONFIG_ENV_SIZE);
@@ -280,6 +585,10 @@ int saveenv(void)
 		error("Cannot export environment: errno = %d\n", errno);
 		goto done;
 	}
+#ifdef CONFIG_ENV_INDEX
+	if (env_index_build((char *)env_new.data, ENV_SIZE, env_htab.size))
+		debug("Saving the environment without an index\n");
+#endif
 	env_new.crc = crc32(0, env_new.data, ENV_SIZE);
 
 	puts("Erasing Flash...");
@@ -291,7 +600,7 @@ int saveenv(void)
 	if (rc != 0)
 		goto perror;
 
-#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE
+#if CONFIG_ENV_SECT_SIZE > CONFIG_ENV_SIZE && !defined(CONFIG_ENV_LOG)
 	if (up_data) {	/* restore the rest of sector */
 		debug("Restoring the rest of data to 0x%lx len 0x%lx\n",
 			(ulong)flash_addr + CONFIG_ENV_SIZE, up_data);
@@ -319,6 +628,17 @@ done:
 
 void env_relocate_spec(void)
 {
+#ifdef CONFIG_ENV_LOG
+	if (gd->env_valid == 2 && gd->env_addr == ENV_LOG_OLD_DATA) {
+		/* The next saveenv writes it out as it is now expected */
+		if (himport_r(&env_htab, (char *)ENV_LOG_OLD_DATA,
+			      ENV_LOG_OLD_SIZE, '\0', 0, 0, NULL))
+			gd->flags |= GD_FLG_ENV_READY;
+		else
+			set_default_env("!import failed");
+		return;
+	}
+#endif
 #ifdef CONFIG_ENV_ADDR_REDUND
 	if (gd->env_addr != (ulong)&(flash_addr->data)) {
 		env_t *etmp = flash_addr;
@@ -360,5 +680,10 @@ void env_relocate_spec(void)
 		     "reading environment; recovered successfully\n\n");
 #endif /* CONFIG_ENV_ADDR_REDUND */
 
+#ifdef CONFIG_ENV_LOG
+	if (env_import((char *)flash_addr, 1))
+		env_log_replay();
+#else
 	env_import((char *)flash_addr, 1);
+#endif
 }
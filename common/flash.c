@@ -25,6 +25,7 @@
 
 #include <common.h>
 #include <flash.h>
+#include <lazy_init.h>
 
 #if !defined(CONFIG_SYS_NO_FLASH)
 #include <mtd/cfi_flash.h>
@@ -108,6 +109,8 @@ addr2info (ulong addr)
 	flash_info_t *info;
 	int i;
 
+	lazy_init("flash");
+
 	for (i=0, info = &flash_info[0]; i<CONFIG_SYS_MAX_FLASH_BANKS; ++i, ++info) {
 		if (info->flash_id != FLASH_UNKNOWN &&
 		    addr >= info->start[0] &&
@@ -54,6 +54,14 @@ static struct hash_algo hash_algo[] = {
 		hw_sha256,
 		CHUNKSZ_SHA256,
 	},
+#endif
+#ifdef CONFIG_MD5_HW_ACCEL
+	{
+		"md5",
+		16,
+		hw_md5,
+		CHUNKSZ_MD5,
+	},
 #endif
 	/*
 	 * This is CONFIG_CMD_SHA1SUM instead of CONFIG_SHA1 since otherwise
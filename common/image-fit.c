@@ -31,7 +31,10 @@
 #include <time.h>
 #else
 #include <common.h>
+#include <aes.h>
 #include <errno.h>
+#include <hw_sha.h>
+#include <malloc.h>
 #include <asm/io.h>
 DECLARE_GLOBAL_DATA_PTR;
 #endif /* !USE_HOSTCC*/
@@ -884,11 +887,20 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 		*((uint32_t *)value) = cpu_to_uimage(*((uint32_t *)value));
 		*value_len = 4;
 	} else if (IMAGE_ENABLE_SHA1 && strcmp(algo, "sha1") == 0) {
+#if defined(CONFIG_SHA_HW_ACCEL) && !defined(USE_HOSTCC)
+		hw_sha1((unsigned char *)data, data_len,
+			(unsigned char *)value, CHUNKSZ_SHA1);
+#else
 		sha1_csum_wd((unsigned char *)data, data_len,
 			     (unsigned char *)value, CHUNKSZ_SHA1);
+#endif
 		*value_len = 20;
 	} else if (IMAGE_ENABLE_MD5 && strcmp(algo, "md5") == 0) {
+#if defined(CONFIG_MD5_HW_ACCEL) && !defined(USE_HOSTCC)
+		hw_md5((unsigned char *)data, data_len, value, CHUNKSZ_MD5);
+#else
 		md5_wd((unsigned char *)data, data_len, value, CHUNKSZ_MD5);
+#endif
 		*value_len = 16;
 	} else {
 		debug("Unsupported hash alogrithm\n");
@@ -1450,6 +1462,108 @@ int fit_image_select(const void *fit, int rd_noffset, int verify)
 	return 0;
 }
 
+#if defined(CONFIG_FIT_CIPHER) && !defined(USE_HOSTCC)
+/*
+ * Default key lookup: there is none, so encrypted images are refused until
+ * the board says where its key is kept by overriding board_fit_cipher_key().
+ * For development only, CONFIG_FIT_CIPHER_KEY_ENV takes the key as a hex
+ * string from the environment variable named by the key-name-hint.
+ */
+int __board_fit_cipher_key(const char *name, u8 *key, int len)
+{
+#ifdef CONFIG_FIT_CIPHER_KEY_ENV
+	const char *s = getenv(name);
+	char hex[3];
+	int i;
+
+	if (!s || strlen(s) != len * 2)
+		return -ENOENT;
+
+	hex[2] = '\0';
+	for (i = 0; i < len; i++) {
+		hex[0] = s[i * 2];
+		hex[1] = s[i * 2 + 1];
+		key[i] = simple_strtoul(hex, NULL, 16);
+	}
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+int board_fit_cipher_key(const char *name, u8 *key, int len)
+	__attribute__((weak, alias("__board_fit_cipher_key")));
+
+static int fit_image_is_encrypted(const void *fit, int noffset)
+{
+	return fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME) >= 0;
+}
+
+/**
+ * fit_image_decrypt() - decrypt an image's data into another buffer
+ *
+ * Hashes are checked on the encrypted data, so this runs after
+ * fit_image_select(). The FIT itself is left as it is, so it can be
+ * verified and loaded again.
+ *
+ * @fit: pointer to the FIT format image header
+ * @noffset: component image node offset
+ * @src: encrypted image data, in the FIT
+ * @dst: buffer for the plaintext, of at least *size bytes
+ * @size: image data size, updated to the plaintext size
+ * @return 0 if ok, -ve on error
+ */
+static int fit_image_decrypt(const void *fit, int noffset, const void *src,
+			     void *dst, size_t *size)
+{
+	const char *algo, *name;
+	const fdt32_t *plain;
+	const void *iv;
+	u8 key[AES_KEY_LENGTH];
+	enum aes_mode mode;
+	int cipher, len, ret;
+
+	cipher = fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME);
+	algo = fdt_getprop(fit, cipher, FIT_ALGO_PROP, NULL);
+	if (algo && !strcmp(algo, "aes128-cbc")) {
+		mode = AES_MODE_CBC;
+	} else if (algo && !strcmp(algo, "aes128-ctr")) {
+		mode = AES_MODE_CTR;
+	} else {
+		printf("Unsupported cipher '%s'\n", algo ? algo : "");
+		return -EPROTONOSUPPORT;
+	}
+
+	iv = fdt_getprop(fit, cipher, FIT_IV_PROP, &len);
+	if (!iv || len != AES_KEY_LENGTH) {
+		puts("Missing or bad cipher iv\n");
+		return -EINVAL;
+	}
+
+	name = fdt_getprop(fit, cipher, FIT_KEY_HINT, NULL);
+	if (!name || board_fit_cipher_key(name, key, sizeof(key))) {
+		printf("No key '%s' to decrypt image\n", name ? name : "");
+		return -EACCES;
+	}
+
+	puts("   Decrypting ... ");
+	ret = hw_aes_crypt(mode, 0, key, (u8 *)iv, src, dst, *size);
+	memset(key, '\0', sizeof(key));
+	if (ret) {
+		printf("failed (%d)\n", ret);
+		return ret;
+	}
+	puts("OK\n");
+
+	/* CBC data is padded to whole blocks, the real size is recorded */
+	plain = fdt_getprop(fit, noffset, FIT_DATA_SIZE_UNCIPHERED_PROP, &len);
+	if (plain && len == sizeof(*plain) && fdt32_to_cpu(*plain) <= *size)
+		*size = fdt32_to_cpu(*plain);
+
+	return 0;
+}
+#endif /* CONFIG_FIT_CIPHER */
+
 int fit_get_node_from_config(bootm_headers_t *images, const char *prop_name,
 			ulong addr)
 {
@@ -1598,6 +1712,42 @@ int fit_image_load(bootm_headers_t *images, const char *prop_name, ulong addr,
 		bootstage_error(bootstage_id + BOOTSTAGE_SUB_GET_DATA);
 		return -ENOENT;
 	}
+#if defined(CONFIG_FIT_CIPHER) && !defined(USE_HOSTCC)
+	/*
+	 * Decrypt straight to the load address if there is one, else into
+	 * a buffer of its own which the caller keeps using.
+	 */
+	if (fit_image_is_encrypted(fit, noffset)) {
+		void *plain;
+		int own = 0;
+
+		if (load_op != FIT_LOAD_IGNORED &&
+		    !fit_image_get_load(fit, noffset, &load)) {
+			if (load < addr + fit_get_size(fit) &&
+			    load + size > addr) {
+				printf("Error: %s overwritten\n", prop_name);
+				return -EXDEV;
+			}
+			plain = map_sysmem(load, size);
+		} else {
+			plain = memalign(ARCH_DMA_MINALIGN, size);
+			if (!plain) {
+				printf("No memory to decrypt %s\n", prop_name);
+				return -ENOMEM;
+			}
+			own = 1;
+		}
+
+		ret = fit_image_decrypt(fit, noffset, buf, plain, &size);
+		if (ret) {
+			if (own)
+				free(plain);
+			bootstage_error(bootstage_id + BOOTSTAGE_SUB_GET_DATA);
+			return ret;
+		}
+		buf = plain;
+	}
+#endif
 	len = (ulong)size;
 
 	/* verify that image data is a proper FDT blob */
@@ -1651,7 +1801,8 @@ int fit_image_load(bootm_headers_t *images, const char *prop_name, ulong addr,
 		       prop_name, data, load);
 
 		dst = map_sysmem(load, len);
-		memmove(dst, buf, len);
+		if (dst != buf)		/* unless decrypted there already */
+			memmove(dst, buf, len);
 		data = load;
 	}
 	bootstage_mark(bootstage_id + BOOTSTAGE_SUB_LOAD);
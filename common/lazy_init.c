@@ -0,0 +1,88 @@
+/*
+ * Subsystems initialised on first use
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * board_init_r() registers the flash, network and PCI setup here instead
+ * of running it, so a bootcmd that only boots from memory-mapped flash
+ * never waits for a JEDEC probe or for a PHY to negotiate. The subsystems
+ * call lazy_init() from their entry points and the setup runs there, the
+ * first time something needs it.
+ */
+
+#include <common.h>
+#include <lazy_init.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+struct lazy_init *lazy_init_find(const char *name)
+{
+	struct lazy_init *entry = ll_entry_start(struct lazy_init, lazy_init);
+	const int count = ll_entry_count(struct lazy_init, lazy_init);
+	int i;
+
+	for (i = 0; i < count; i++, entry++)
+		if (!strcmp(name, entry->name))
+			return entry;
+
+	return NULL;
+}
+
+int lazy_init(const char *name)
+{
+	struct lazy_init *entry;
+	ulong start;
+
+	/* The list is only writable once we run from RAM */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return 0;
+
+	entry = lazy_init_find(name);
+	if (!entry || entry->state == LAZY_INIT_RUNNING)
+		return 0;
+	if (entry->state == LAZY_INIT_DONE)
+		return entry->ret;
+
+	debug("lazy init: %s\n", name);
+	entry->state = LAZY_INIT_RUNNING;
+	start = timer_get_boot_us();
+	entry->ret = entry->init();
+	entry->us = timer_get_boot_us() - start;
+	entry->state = LAZY_INIT_DONE;
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, entry->name);
+
+	return entry->ret;
+}
+
+void lazy_init_report(void)
+{
+	struct lazy_init *entry = ll_entry_start(struct lazy_init, lazy_init);
+	const int count = ll_entry_count(struct lazy_init, lazy_init);
+	int i;
+
+	for (i = 0; i < count; i++, entry++) {
+		printf("%-10s ", entry->name);
+		if (entry->state != LAZY_INIT_DONE)
+			puts("not used\n");
+		else if (entry->ret)
+			printf("failed (%d) after %lu us\n", entry->ret,
+			       entry->us);
+		else
+			printf("%lu us\n", entry->us);
+	}
+}
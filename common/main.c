@@ -28,6 +28,7 @@
 /* #define	DEBUG	*/
 
 #include <common.h>
+#include <boot_prep.h>
 #include <command.h>
 #include <fdtdec.h>
 #include <hush.h>
@@ -182,6 +183,8 @@ static int abortboot_keyed(int bootdelay)
 				abort = 1;
 			}
 		}
+		if (!abort)
+			boot_prep_step();
 	} while (!abort && get_ticks() <= etime);
 
 	if (!abort)
@@ -242,7 +245,8 @@ static int abortboot_normal(int bootdelay)
 # endif
 				break;
 			}
-			udelay(10000);
+			if (!boot_prep_step())
+				udelay(10000);
 		} while (!abort && get_timer(ts) < 1000);
 
 		printf("\b\b\b%2d ", bootdelay);
@@ -407,6 +411,10 @@ static void process_boot_delay(void)
 
 	debug ("### main_loop: bootcmd=\"%s\"\n", s ? s : "<UNDEFINED>");
 
+	/* unpack the kernel while we wait, if bootcmd is a plain bootm */
+	if (bootdelay > 0 && s)
+		boot_prep_cmd(s);
+
 	if (bootdelay != -1 && s && !abortboot(bootdelay)) {
 #ifdef CONFIG_AUTOBOOT_KEYED
 		int prev = disable_ctrlc(1);	/* disable Control C checking */
@@ -418,6 +426,8 @@ static void process_boot_delay(void)
 		disable_ctrlc(prev);	/* restore Control C checking */
 #endif
 	}
+	/* stopped, or the boot failed: nothing may trust the image now */
+	boot_prep_cancel();
 
 #ifdef CONFIG_MENUKEY
 	if (menukey == CONFIG_MENUKEY) {
@@ -0,0 +1,230 @@
+/*
+ * Sampling profiler
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Function trace costs a call into lib/trace.c on every function entry
+ * and exit, which swamps tight loops such as checksums and flash writes.
+ * Here a timer interrupt instead notes where the CPU was, a few hundred
+ * or thousand times a second, in a histogram of the code. Where the most
+ * samples land is where the time goes.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#include <profile.h>
+#include <asm/sections.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#ifndef CONFIG_PROFILE_HZ
+#define CONFIG_PROFILE_HZ	1000
+#endif
+
+/* Samples are counted per (1 << CONFIG_PROFILE_SHIFT) bytes of code */
+#ifndef CONFIG_PROFILE_SHIFT
+#define CONFIG_PROFILE_SHIFT	4
+#endif
+
+static struct {
+	u32 *pc_hist;		/* samples by interrupted address */
+	u32 *caller_hist;	/* and by the caller of that function */
+	ulong base;		/* code address of the first bucket */
+	ulong buckets;
+	ulong samples;		/* taken since profile_clear() */
+	ulong outside;		/* of those, not in U-Boot's code */
+	unsigned int hz;
+	int running;
+} prof;
+
+/* A line of the report */
+struct profile_func {
+	ulong addr;		/* System.map address */
+	const char *name;	/* or NULL without CONFIG_KALLSYMS */
+	ulong self;		/* samples in the function */
+	ulong callees;		/* samples in the functions it called */
+};
+
+static ulong profile_code_base(void)
+{
+#ifdef CONFIG_SANDBOX
+	return (ulong)&_init;
+#else
+	return gd->relocaddr;
+#endif
+}
+
+/* Where System.map puts code we are running at addr */
+static ulong profile_map_addr(ulong addr)
+{
+#ifdef CONFIG_SANDBOX
+	return addr;
+#else
+	return addr - gd->reloc_off;
+#endif
+}
+
+void __attribute__((no_instrument_function)) profile_sample(ulong pc,
+							     ulong caller)
+{
+	ulong i = (pc - prof.base) >> CONFIG_PROFILE_SHIFT;
+
+	prof.samples++;
+	if (i < prof.buckets)
+		prof.pc_hist[i]++;
+	else
+		prof.outside++;
+
+	i = (caller - prof.base) >> CONFIG_PROFILE_SHIFT;
+	if (caller && i < prof.buckets)
+		prof.caller_hist[i]++;
+}
+
+int profile_start(unsigned int hz)
+{
+	int ret;
+
+	if (prof.running)
+		return -EBUSY;
+	if (!prof.pc_hist) {
+		prof.base = profile_code_base();
+		prof.buckets = (gd->mon_len >> CONFIG_PROFILE_SHIFT) + 1;
+		prof.pc_hist = calloc(prof.buckets * 2, sizeof(u32));
+		if (!prof.pc_hist)
+			return -ENOMEM;
+		prof.caller_hist = prof.pc_hist + prof.buckets;
+	}
+
+	if (!hz)
+		hz = CONFIG_PROFILE_HZ;
+	ret = profile_timer_start(hz);
+	if (ret)
+		return ret;
+	prof.hz = hz;
+	prof.running = 1;
+
+	return 0;
+}
+
+void profile_stop(void)
+{
+	if (prof.running) {
+		profile_timer_stop();
+		prof.running = 0;
+	}
+}
+
+void profile_clear(void)
+{
+	if (prof.pc_hist)
+		memset(prof.pc_hist, '\0', prof.buckets * 2 * sizeof(u32));
+	prof.samples = 0;
+	prof.outside = 0;
+}
+
+ulong profile_count(ulong start, ulong end)
+{
+	ulong i, count = 0;
+
+	if (!prof.pc_hist || end <= start || end <= prof.base)
+		return 0;
+	start = max(start, prof.base) - prof.base;
+	end -= prof.base;
+	for (i = start >> CONFIG_PROFILE_SHIFT;
+	     i <= (end - 1) >> CONFIG_PROFILE_SHIFT && i < prof.buckets; i++)
+		count += prof.pc_hist[i];
+
+	return count;
+}
+
+static int h_cmp_self(const void *v1, const void *v2)
+{
+	const struct profile_func *f1 = v1, *f2 = v2;
+
+	if (f1->self != f2->self)
+		return f1->self < f2->self ? 1 : -1;
+	if (f1->callees != f2->callees)
+		return f1->callees < f2->callees ? 1 : -1;
+
+	return 0;
+}
+
+static void print_percent(ulong count)
+{
+	ulong tenths = count * 1000 / max(prof.samples, 1UL);
+
+	printf("%3lu.%lu%%", tenths / 10, tenths % 10);
+}
+
+void profile_report(int max_lines)
+{
+	struct profile_func *funcs, *func;
+	ulong i, count;
+
+	printf("%lu samples at %u Hz, %lu outside U-Boot\n", prof.samples,
+	       prof.hz, prof.outside);
+	if (!prof.pc_hist)
+		return;
+
+	for (i = 0, count = 0; i < prof.buckets; i++)
+		count += prof.pc_hist[i] || prof.caller_hist[i];
+	if (!count)
+		return;
+	funcs = calloc(count, sizeof(*funcs));
+	if (!funcs) {
+		puts("No memory for the report\n");
+		return;
+	}
+
+	/* Buckets are in address order, so a function's are together */
+	for (i = 0, count = 0; i < prof.buckets; i++) {
+		ulong addr, self = prof.pc_hist[i];
+		ulong callees = prof.caller_hist[i];
+		const char *name = NULL;
+
+		if (!self && !callees)
+			continue;
+		addr = prof.base + (i << CONFIG_PROFILE_SHIFT);
+		addr = profile_map_addr(addr);
+#ifdef CONFIG_KALLSYMS
+		name = symbol_lookup(addr, &addr);
+#endif
+		if (!count || funcs[count - 1].addr != addr) {
+			funcs[count].addr = addr;
+			funcs[count].name = name;
+			count++;
+		}
+		func = &funcs[count - 1];
+		func->self += self;
+		func->callees += callees;
+	}
+	qsort(funcs, count, sizeof(*funcs), h_cmp_self);
+
+	puts("    self             callees          address   function\n");
+	for (i = 0; i < count && i < (ulong)max_lines; i++) {
+		func = &funcs[i];
+		printf("%8lu ", func->self);
+		print_percent(func->self);
+		printf("  %8lu ", func->callees);
+		print_percent(func->callees);
+		printf("  %08lx  %s\n", func->addr,
+		       func->name ? func->name : "");
+	}
+	free(funcs);
+}
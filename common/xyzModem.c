@@ -105,17 +105,15 @@ CYGACC_COMM_IF_GETC_TIMEOUT (char chan, char *c)
 {
 #define DELAY 20
   unsigned long counter = 0;
-  while (!tstc () && (counter < xyzModem_CHAR_TIMEOUT * 1000 / DELAY))
+  /* At high baud rates a second tstc() per byte is already too slow */
+  while (!tstc ())
     {
+      if (counter++ >= xyzModem_CHAR_TIMEOUT * 1000 / DELAY)
+	return 0;
       udelay (DELAY);
-      counter++;
     }
-  if (tstc ())
-    {
-      *c = getc ();
-      return 1;
-    }
-  return 0;
+  *c = getc ();
+  return 1;
 }
 
 static void
@@ -331,6 +329,15 @@ zm_dump (int line)
 #define ZM_DEBUG(x)
 #endif
 
+/* What asks the sender for the next file, or for a block again */
+static char
+xyzModem_start_char (void)
+{
+  if (xyz.mode == xyzModem_ymodem_g)
+    return 'G';
+  return xyz.crc_mode ? 'C' : NAK;
+}
+
 /* Wait for the line to go idle */
 static void
 xyzModem_flush (void)
@@ -561,7 +568,7 @@ xyzModem_stream_open (connection_info_t * info, int *err)
   xyz.file_length = 0;
 #endif
 
-  CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
+  CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_start_char ());
 
   if (xyz.mode == xyzModem_xmodem)
     {
@@ -585,7 +592,11 @@ xyzModem_stream_open (connection_info_t * info, int *err)
 	      parse_num ((char *) xyz.bufp, &xyz.file_length, NULL, " ");
 #endif
 	      /* The rest of the file name data block quietly discarded */
-	      xyz.tx_ack = true;
+	      if (xyz.mode == xyzModem_ymodem_g)
+		/* Streaming: no ACK, a G has the data blocks sent */
+		CYGACC_COMM_IF_PUTC (*xyz.__chan, 'G');
+	      else
+		xyz.tx_ack = true;
 	    }
 	  xyz.next_blk = 1;
 	  xyz.len = 0;
@@ -593,10 +604,11 @@ xyzModem_stream_open (connection_info_t * info, int *err)
 	}
       else if (stat == xyzModem_timeout)
 	{
-	  if (--crc_retries <= 0)
+	  /* Y-modem-g has no checksum mode to fall back to */
+	  if (xyz.mode != xyzModem_ymodem_g && --crc_retries <= 0)
 	    xyz.crc_mode = false;
 	  CYGACC_CALL_IF_DELAY_US (5 * 100000);	/* Extra delay for startup */
-	  CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
+	  CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_start_char ());
 	  xyz.total_retries++;
 	  ZM_DEBUG (zm_dprintf ("NAK (%d)\n", __LINE__));
 	}
@@ -631,7 +643,8 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		{
 		  if (xyz.blk == xyz.next_blk)
 		    {
-		      xyz.tx_ack = true;
+		      /* Y-modem-g blocks stream in without ACKs */
+		      xyz.tx_ack = (xyz.mode != xyzModem_ymodem_g);
 		      ZM_DEBUG (zm_dprintf
 				("ACK block %d (%d)\n", xyz.blk, __LINE__));
 		      xyz.next_blk = (xyz.next_blk + 1) & 0xFF;
@@ -675,7 +688,8 @@ xyzModem_stream_read (char *buf, int size, int *err)
 #endif
 		      break;
 		    }
-		  else if (xyz.blk == ((xyz.next_blk - 1) & 0xFF))
+		  else if (xyz.mode != xyzModem_ymodem_g &&
+			   xyz.blk == ((xyz.next_blk - 1) & 0xFF))
 		    {
 		      /* Just re-ACK this so sender will get on with it */
 		      CYGACC_COMM_IF_PUTC (*xyz.__chan, ACK);
@@ -694,10 +708,10 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		{
 		  CYGACC_COMM_IF_PUTC (*xyz.__chan, ACK);
 		  ZM_DEBUG (zm_dprintf ("ACK (%d)\n", __LINE__));
-		  if (xyz.mode == xyzModem_ymodem)
+		  if (xyz.mode != xyzModem_xmodem)
 		    {
 		      CYGACC_COMM_IF_PUTC (*xyz.__chan,
-					   (xyz.crc_mode ? 'C' : NAK));
+					   xyzModem_start_char ());
 		      xyz.total_retries++;
 		      ZM_DEBUG (zm_dprintf ("Reading Final Header\n"));
 		      stat = xyzModem_get_hdr ();
@@ -707,7 +721,10 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		  xyz.at_eof = true;
 		  break;
 		}
-	      CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
+	      /* A streaming sender can't go back: give up on the first error */
+	      if (xyz.mode == xyzModem_ymodem_g)
+		break;
+	      CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_start_char ());
 	      xyz.total_retries++;
 	      ZM_DEBUG (zm_dprintf ("NAK (%d)\n", __LINE__));
 	    }
@@ -759,6 +776,7 @@ xyzModem_stream_terminate (bool abort, int (*getc) (void))
 	{
 	case xyzModem_xmodem:
 	case xyzModem_ymodem:
+	case xyzModem_ymodem_g:
 	  /* The X/YMODEM Spec seems to suggest that multiple CAN followed by an equal */
 	  /* number of Backspaces is a friendly way to get the other end to abort. */
 	  CYGACC_COMM_IF_PUTC (*xyz.__chan, CAN);
@@ -0,0 +1,484 @@
+/*
+ * Aspeed Hash And Crypto Engine (HACE) hash and cipher support
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <common.h>
+#include <hw_sha.h>
+#include <sha1.h>
+#include <sha256.h>
+#include <watchdog.h>
+#include <u-boot/md5.h>
+#include <asm/io.h>
+#include <asm/errno.h>
+#include <asm/arch/hace.h>
+
+/* Longest single engine command, and how long it may take (ms) */
+#define HACE_MAX_LEN		(1024 * 1024)
+#define HACE_TIMEOUT		1000
+
+/* Below this size setting up the engine costs more than it saves */
+#ifndef CONFIG_ASPEED_HACE_MIN_LEN
+#define CONFIG_ASPEED_HACE_MIN_LEN	256
+#endif
+
+/* Initial state, in the byte order the engine keeps it in the digest */
+static const u8 md5_iv[16] = {
+	0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+};
+
+static const u8 sha1_iv[20] = {
+	0x67, 0x45, 0x23, 0x01, 0xef, 0xcd, 0xab, 0x89,
+	0x98, 0xba, 0xdc, 0xfe, 0x10, 0x32, 0x54, 0x76,
+	0xc3, 0xd2, 0xe1, 0xf0,
+};
+
+static const u8 sha256_iv[32] = {
+	0x6a, 0x09, 0xe6, 0x67, 0xbb, 0x67, 0xae, 0x85,
+	0x3c, 0x6e, 0xf3, 0x72, 0xa5, 0x4f, 0xf5, 0x3a,
+	0x51, 0x0e, 0x52, 0x7f, 0x9b, 0x05, 0x68, 0x8c,
+	0x1f, 0x83, 0xd9, 0xab, 0x5b, 0xe0, 0xcd, 0x19,
+};
+
+static int hace_enabled;
+
+/* Past this size cleaning the whole D-cache beats walking the range */
+#define HACE_FLUSH_ALL_LEN	(32 * 1024)
+
+/* Write back CPU data the engine is about to read */
+static void hace_flush(const void *addr, unsigned int len)
+{
+	ulong start = (ulong)addr & ~(ARCH_DMA_MINALIGN - 1);
+
+	if (len >= HACE_FLUSH_ALL_LEN) {
+		flush_dcache_all();
+		return;
+	}
+	flush_dcache_range(start, ALIGN((ulong)addr + len, ARCH_DMA_MINALIGN));
+}
+
+/* Discard cached copies of data the engine has written */
+static void hace_invalidate(const void *addr, unsigned int len)
+{
+	ulong start = (ulong)addr & ~(ARCH_DMA_MINALIGN - 1);
+
+	invalidate_dcache_range(start,
+				ALIGN((ulong)addr + len, ARCH_DMA_MINALIGN));
+}
+
+/* Ungate the engine clock and take it out of reset */
+static void hace_enable(void)
+{
+	if (hace_enabled)
+		return;
+
+	writel(HACE_SCU_KEY, HACE_SCU_BASE);
+	clrbits_le32(HACE_SCU_BASE + 0x0c, HACE_SCU_CLK_STOP);
+	udelay(100);
+	clrbits_le32(HACE_SCU_BASE + 0x04, HACE_SCU_RESET);
+	hace_enabled = 1;
+}
+
+/*
+ * Put the engine back in reset and take it out again. A command that has
+ * timed out may still be running, and must not have the next one written
+ * over it.
+ */
+static void hace_reset(void)
+{
+	writel(HACE_SCU_KEY, HACE_SCU_BASE);
+	setbits_le32(HACE_SCU_BASE + 0x04, HACE_SCU_RESET);
+	udelay(100);
+	clrbits_le32(HACE_SCU_BASE + 0x04, HACE_SCU_RESET);
+}
+
+/* Run whole blocks through the engine, updating ctx->digest */
+static int hace_hash_blocks(struct hace_hash_ctx *ctx, const void *src,
+			    unsigned int len)
+{
+	ulong start;
+
+	hace_flush(src, len);
+	hace_flush(ctx->digest, sizeof(ctx->digest));
+
+	writel((ulong)src, HACE_HASH_SRC);
+	writel((ulong)ctx->digest, HACE_HASH_DIGEST);
+	writel(len, HACE_HASH_LEN);
+	writel(ctx->cmd, HACE_HASH_CMD);
+
+	start = get_timer(0);
+	while (readl(HACE_STATUS) & HACE_HASH_BUSY) {
+		if (get_timer(start) > HACE_TIMEOUT) {
+			debug("%s: engine timed out\n", __func__);
+			hace_reset();
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+
+	return 0;
+}
+
+int hace_hash_init(struct hace_hash_ctx *ctx, enum hace_hash_algo algo)
+{
+	const u8 *iv;
+
+	switch (algo) {
+	case HACE_ALGO_MD5:
+		ctx->cmd = HACE_HASH_MD5;
+		iv = md5_iv;
+		ctx->digest_len = sizeof(md5_iv);
+		break;
+	case HACE_ALGO_SHA1:
+		ctx->cmd = HACE_HASH_SHA1 | HACE_HASH_SHA_SWAP;
+		iv = sha1_iv;
+		ctx->digest_len = sizeof(sha1_iv);
+		break;
+	case HACE_ALGO_SHA256:
+		ctx->cmd = HACE_HASH_SHA256 | HACE_HASH_SHA_SWAP;
+		iv = sha256_iv;
+		ctx->digest_len = sizeof(sha256_iv);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	hace_enable();
+	ctx->cmd |= HACE_HASH_ACCUM;
+	ctx->algo = algo;
+	ctx->buf_len = 0;
+	ctx->total = 0;
+	memcpy(ctx->digest, iv, ctx->digest_len);
+
+	return 0;
+}
+
+int hace_hash_update(struct hace_hash_ctx *ctx, const void *data,
+		     unsigned int len)
+{
+	const u8 *p = data;
+	unsigned int n;
+	int ret;
+
+	ctx->total += len;
+
+	/* top up a partial block left by the last call, and no more */
+	if (ctx->buf_len) {
+		n = min(len, HACE_HASH_BLOCK - ctx->buf_len);
+		memcpy(ctx->buf + ctx->buf_len, p, n);
+		ctx->buf_len += n;
+		p += n;
+		len -= n;
+		if (ctx->buf_len < HACE_HASH_BLOCK)
+			return 0;
+		ctx->buf_len = 0;
+		ret = hace_hash_blocks(ctx, ctx->buf, HACE_HASH_BLOCK);
+		if (ret)
+			return ret;
+	}
+
+	while (len >= HACE_HASH_BLOCK) {
+		if (!((ulong)p & (HACE_SRC_ALIGN - 1))) {
+			/* hash straight from the caller's buffer */
+			n = min(len, (unsigned int)HACE_MAX_LEN);
+			n &= ~(HACE_HASH_BLOCK - 1);
+			ret = hace_hash_blocks(ctx, p, n);
+		} else {
+			n = min(len, (unsigned int)HACE_HASH_BUF_SIZE);
+			n &= ~(HACE_HASH_BLOCK - 1);
+			memcpy(ctx->buf, p, n);
+			ret = hace_hash_blocks(ctx, ctx->buf, n);
+		}
+		if (ret)
+			return ret;
+		p += n;
+		len -= n;
+	}
+
+	memcpy(ctx->buf, p, len);
+	ctx->buf_len = len;
+
+	return 0;
+}
+
+int hace_hash_finish(struct hace_hash_ctx *ctx, u8 *out)
+{
+	u64 bits = ctx->total << 3;
+	unsigned int len = ctx->buf_len;
+	int i, ret;
+
+	/* MD padding: 0x80, zeroes up to 56 mod 64, then the bit count */
+	ctx->buf[len++] = 0x80;
+	while ((len & (HACE_HASH_BLOCK - 1)) != HACE_HASH_BLOCK - 8)
+		ctx->buf[len++] = 0;
+	for (i = 0; i < 8; i++) {
+		if (ctx->algo == HACE_ALGO_MD5)
+			ctx->buf[len + i] = bits >> (i * 8);
+		else
+			ctx->buf[len + 7 - i] = bits >> (i * 8);
+	}
+	len += 8;
+
+	ret = hace_hash_blocks(ctx, ctx->buf, len);
+	ctx->buf_len = 0;
+	if (ret)
+		return ret;
+
+	hace_invalidate(ctx->digest, sizeof(ctx->digest));
+	memcpy(out, ctx->digest, ctx->digest_len);
+	return 0;
+}
+
+/*
+ * One-shot digest for the hash_algo table. Returns non-zero when the
+ * engine should not or could not be used, so that the caller can fall
+ * back to the software implementation.
+ */
+static int hace_digest(enum hace_hash_algo algo, const uchar *in, uint len,
+		       uchar *out, uint chunk_size)
+{
+	struct hace_hash_ctx ctx;
+	int ret;
+
+	if (len < CONFIG_ASPEED_HACE_MIN_LEN ||
+	    ((ulong)in & (HACE_SRC_ALIGN - 1)))
+		return -EINVAL;
+
+	/* The watchdog is kicked while waiting, so chunk_size is not needed */
+	ret = hace_hash_init(&ctx, algo);
+	if (!ret)
+		ret = hace_hash_update(&ctx, in, len);
+	if (!ret)
+		ret = hace_hash_finish(&ctx, out);
+
+	return ret;
+}
+
+void hw_sha1(const uchar *in_addr, uint buflen, uchar *out_addr,
+	     uint chunk_size)
+{
+	if (hace_digest(HACE_ALGO_SHA1, in_addr, buflen, out_addr, chunk_size))
+		sha1_csum_wd(in_addr, buflen, out_addr, chunk_size);
+}
+
+void hw_sha256(const uchar *in_addr, uint buflen, uchar *out_addr,
+	       uint chunk_size)
+{
+	if (hace_digest(HACE_ALGO_SHA256, in_addr, buflen, out_addr,
+			chunk_size))
+		sha256_csum_wd(in_addr, buflen, out_addr, chunk_size);
+}
+
+void hw_md5(const uchar *in_addr, uint buflen, uchar *out_addr,
+	    uint chunk_size)
+{
+	if (hace_digest(HACE_ALGO_MD5, in_addr, buflen, out_addr, chunk_size))
+		md5_wd((unsigned char *)in_addr, buflen, out_addr, chunk_size);
+}
+
+#ifdef CONFIG_AES
+/* Run one cipher command, the context holding the IV and key material */
+static int hace_crypto_run(const void *context, unsigned int context_len,
+			   u32 cmd, const void *src, void *dst,
+			   unsigned int len)
+{
+	ulong start;
+
+	hace_flush(context, context_len);
+	hace_flush(src, len);
+	if (dst != src)
+		hace_flush(dst, len);
+
+	writel((ulong)src, HACE_CRYPTO_SRC);
+	writel((ulong)dst, HACE_CRYPTO_DST);
+	writel((ulong)context, HACE_CRYPTO_CONTEXT);
+	writel(len, HACE_CRYPTO_LEN);
+	writel(cmd, HACE_CRYPTO_CMD);
+
+	start = get_timer(0);
+	while (readl(HACE_STATUS) & HACE_CRYPTO_BUSY) {
+		if (get_timer(start) > HACE_TIMEOUT) {
+			debug("%s: engine timed out\n", __func__);
+			hace_reset();
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+	hace_invalidate(dst, len);
+
+	return 0;
+}
+
+/* Add a block count to a big-endian 128-bit counter */
+static void hace_ctr_add(u8 *ctr, u32 blocks)
+{
+	u32 carry = blocks;
+	int i;
+
+	for (i = HACE_AES_BLOCK - 1; i >= 0 && carry; i--) {
+		carry += ctr[i];
+		ctr[i] = carry;
+		carry >>= 8;
+	}
+}
+
+int hace_aes_init(struct hace_aes_ctx *ctx, enum aes_mode mode,
+		  u8 *key, const u8 *iv)
+{
+	switch (mode) {
+	case AES_MODE_ECB:
+		ctx->cmd = HACE_CRYPTO_ECB;
+		break;
+	case AES_MODE_CBC:
+		ctx->cmd = HACE_CRYPTO_CBC;
+		break;
+	case AES_MODE_CTR:
+		ctx->cmd = HACE_CRYPTO_CTR;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	hace_enable();
+	ctx->cmd |= HACE_CRYPTO_AES | HACE_CRYPTO_AES128;
+	ctx->mode = mode;
+	if (iv)
+		memcpy(ctx->context, iv, HACE_AES_BLOCK);
+	else
+		memset(ctx->context, 0, HACE_AES_BLOCK);
+
+	/* lib/aes.c keeps the schedule in the byte order the engine wants */
+	aes_expand_key(key, ctx->context + HACE_AES_BLOCK);
+
+	return 0;
+}
+
+int hace_aes_crypt(struct hace_aes_ctx *ctx, int encrypt, const void *src,
+		   void *dst, unsigned int len)
+{
+	const u8 *in = src;
+	u8 *out = dst;
+	u8 last[HACE_AES_BLOCK];
+	unsigned int n, tail;
+	u32 cmd;
+	int i, ret;
+
+	if (((ulong)in | (ulong)out) & (HACE_CRYPTO_ALIGN - 1))
+		return -EINVAL;
+	tail = len & (HACE_AES_BLOCK - 1);
+	if (tail && ctx->mode != AES_MODE_CTR)
+		return -EINVAL;
+	len -= tail;
+
+	cmd = ctx->cmd | (encrypt ? HACE_CRYPTO_ENCRYPT : 0);
+	while (len) {
+		n = min(len, (unsigned int)HACE_MAX_LEN);
+
+		/* an in-place decrypt overwrites the next IV, keep it */
+		if (ctx->mode == AES_MODE_CBC && !encrypt)
+			memcpy(last, in + n - HACE_AES_BLOCK, HACE_AES_BLOCK);
+
+		ret = hace_crypto_run(ctx->context, sizeof(ctx->context), cmd,
+				      in, out, n);
+		if (ret)
+			return ret;
+
+		if (ctx->mode == AES_MODE_CBC)
+			memcpy(ctx->context,
+			       encrypt ? out + n - HACE_AES_BLOCK : last,
+			       HACE_AES_BLOCK);
+		else if (ctx->mode == AES_MODE_CTR)
+			hace_ctr_add(ctx->context, n / HACE_AES_BLOCK);
+
+		in += n;
+		out += n;
+		len -= n;
+		WATCHDOG_RESET();
+	}
+
+	/* Trailing partial CTR block: one block of key stream in software */
+	if (tail) {
+		aes_encrypt(ctx->context, ctx->context + HACE_AES_BLOCK, last);
+		for (i = 0; i < tail; i++)
+			out[i] = in[i] ^ last[i];
+		hace_ctr_add(ctx->context, 1);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_AES_HW_ACCEL
+/* Software path for buffers the engine cannot reach */
+static void aes_sw_crypt(struct hace_aes_ctx *ctx, int encrypt,
+			 const u8 *in, u8 *out, unsigned int len)
+{
+	u8 *iv = ctx->context;
+	u8 *expkey = ctx->context + HACE_AES_BLOCK;
+	u8 tmp[HACE_AES_BLOCK];
+	unsigned int n;
+	int i;
+
+	for (; len; len -= n, in += n, out += n) {
+		n = min(len, (unsigned int)HACE_AES_BLOCK);
+		memcpy(tmp, in, n);
+
+		switch (ctx->mode) {
+		case AES_MODE_ECB:
+			if (encrypt)
+				aes_encrypt(tmp, expkey, out);
+			else
+				aes_decrypt(tmp, expkey, out);
+			break;
+		case AES_MODE_CBC:
+			if (encrypt) {
+				for (i = 0; i < n; i++)
+					tmp[i] ^= iv[i];
+				aes_encrypt(tmp, expkey, out);
+				memcpy(iv, out, HACE_AES_BLOCK);
+			} else {
+				aes_decrypt(tmp, expkey, out);
+				for (i = 0; i < n; i++)
+					out[i] ^= iv[i];
+				memcpy(iv, tmp, HACE_AES_BLOCK);
+			}
+			break;
+		case AES_MODE_CTR:
+			aes_encrypt(iv, expkey, out);
+			for (i = 0; i < n; i++)
+				out[i] ^= tmp[i];
+			hace_ctr_add(iv, 1);
+			break;
+		}
+	}
+}
+
+int hw_aes_crypt(enum aes_mode mode, int encrypt, u8 *key, u8 *iv,
+		 const void *src, void *dst, unsigned int len)
+{
+	struct hace_aes_ctx ctx;
+	int ret;
+
+	if (mode != AES_MODE_CTR && (len & (HACE_AES_BLOCK - 1)))
+		return -EINVAL;
+	ret = hace_aes_init(&ctx, mode, key, iv);
+	if (ret)
+		return ret;
+
+	if (((ulong)src | (ulong)dst) & (HACE_CRYPTO_ALIGN - 1)) {
+		aes_sw_crypt(&ctx, encrypt, src, dst, len);
+		return 0;
+	}
+
+	return hace_aes_crypt(&ctx, encrypt, src, dst, len);
+}
+#endif /* CONFIG_AES_HW_ACCEL */
+#endif /* CONFIG_AES */
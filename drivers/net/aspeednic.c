@@ -18,6 +18,14 @@
 #include <pci.h>
 #include <linux/mii.h>
 
+/*
+ * Two 16 byte descriptors share each cache line, so writing one back
+ * could overwrite the MAC's update of its neighbour. With a write-through
+ * D-cache no line is ever dirty and the maintenance below is enough.
+ */
+#if !defined(CONFIG_SYS_DCACHE_OFF) && !defined(CONFIG_SYS_ARM_CACHE_WRITETHROUGH)
+#error "aspeednic needs CONFIG_SYS_ARM_CACHE_WRITETHROUGH or CONFIG_SYS_DCACHE_OFF"
+#endif
 
 /*
   SCU88 D[31]: MAC1 MDIO
@@ -405,6 +413,29 @@ static unsigned char rx_buffer[NUM_RX_DESC][RX_BUFF_SZ] __attribute__ ((aligned(
 
 static char rxRingSize;
 static char txRingSize;
+
+/* Make CPU writes visible to the MAC, rounding out to whole cache lines */
+static void dma_flush(volatile void *addr, unsigned long len)
+{
+  unsigned long start = (unsigned long)addr & ~(ARCH_DMA_MINALIGN - 1);
+
+  flush_dcache_range(start, ALIGN((unsigned long)addr + len, ARCH_DMA_MINALIGN));
+}
+
+/* Drop cached copies so the CPU sees what the MAC wrote */
+static void dma_invalidate(volatile void *addr, unsigned long len)
+{
+  unsigned long start = (unsigned long)addr & ~(ARCH_DMA_MINALIGN - 1);
+
+  invalidate_dcache_range(start, ALIGN((unsigned long)addr + len, ARCH_DMA_MINALIGN));
+}
+
+/* Is the current TX descriptor still owned by the MAC? */
+static int tx_busy(void)
+{
+  dma_invalidate(&tx_ring[tx_new], sizeof(tx_ring[0]));
+  return (tx_ring[tx_new].status & cpu_to_le32(TXDMA_OWN)) == 0x80000000;
+}
 static unsigned int InstanceID = 0;
 static int Retry = 0;
 
@@ -656,6 +687,7 @@ void NCSI_Rx (void)
   unsigned long status, length, i = 0;
 
   do {
+    dma_invalidate(&rx_ring[rx_new], sizeof(rx_ring[0]));
     status = (s32)le32_to_cpu(rx_ring[rx_new].status);
     i++;
   } while (!(((status & RXPKT_STATUS) != 0) || (i >= NCSI_LOOP)));
@@ -663,9 +695,11 @@ void NCSI_Rx (void)
   if (i < NCSI_LOOP) {
     if (status & LRS) {
       length = (le32_to_cpu(rx_ring[rx_new].status) & 0x3FFF);
+      dma_invalidate((void *)rx_ring[rx_new].buf, length);
       memcpy (&NCSI_Respond, (unsigned char *)rx_ring[rx_new].buf, length);
     }
     rx_ring[rx_new].status &= cpu_to_le32(0x7FFFFFFF);
+    dma_flush(&rx_ring[rx_new], sizeof(rx_ring[0]));
     rx_new = (rx_new + 1) % rxRingSize;
   }
 }
@@ -1219,6 +1253,10 @@ static int aspeednic_init(struct eth_device* dev, bd_t* bis)
   rx_ring[rxRingSize - 1].status |= cpu_to_le32(EDORR);
   tx_ring[txRingSize - 1].status |= cpu_to_le32(EDOTR);
 
+  dma_invalidate(rx_buffer, sizeof(rx_buffer));
+  dma_flush(rx_ring, sizeof(rx_ring));
+  dma_flush(tx_ring, sizeof(tx_ring));
+
   OUTL(dev, ((u32) &tx_ring), TXR_BADR_REG);
   OUTL(dev, ((u32) &rx_ring), RXR_BADR_REG);
 
@@ -1293,7 +1331,7 @@ static int aspeednic_send(struct eth_device* dev, volatile void *packet, int len
   }
 
 
-  for(i = 0; (tx_ring[tx_new].status & cpu_to_le32(TXDMA_OWN)) == 0x80000000; i++) {
+  for(i = 0; tx_busy(); i++) {
     if (i >= TOUT_LOOP) {
       printf("%s: tx error buffer not ready\n", dev->name);
       fail = 1;
@@ -1307,14 +1345,16 @@ static int aspeednic_send(struct eth_device* dev, volatile void *packet, int len
 //            memset ((void *)cpu_to_le32((u32) (packet + length)), 0, 60 - length);
     length = 60;
   }
+  dma_flush(packet, length);
   tx_ring[tx_new].buf    = cpu_to_le32(((u32) packet));
   tx_ring[tx_new].status   &= (~(0x3FFF));
   tx_ring[tx_new].status   |= cpu_to_le32(LTS | FTS | length);
   tx_ring[tx_new].status |= cpu_to_le32(TXDMA_OWN);
+  dma_flush(&tx_ring[tx_new], sizeof(tx_ring[0]));
 
   OUTL(dev, POLL_DEMAND, TXPD_REG);
 
-  for (i = 0; (tx_ring[tx_new].status & cpu_to_le32(TXDMA_OWN)) == 0x80000000; i++)
+  for (i = 0; tx_busy(); i++)
   {
     if (i >= TOUT_LOOP)
     {
@@ -1341,6 +1381,7 @@ static int aspeednic_recv(struct eth_device* dev)
 
   for ( ; ; )
   {
+    dma_invalidate(&rx_ring[rx_new], sizeof(rx_ring[0]));
     status = (s32)le32_to_cpu(rx_ring[rx_new].status);
 
     if ((status & RXPKT_STATUS) == 0) {
@@ -1366,6 +1407,7 @@ static int aspeednic_recv(struct eth_device* dev)
         /* Pass the packet up to the protocol
          * layers.
          */
+        dma_invalidate(rx_buffer[rx_new], length);
         NetReceive(rx_buffer[rx_new], length - 4);
       }
 
@@ -1374,6 +1416,7 @@ static int aspeednic_recv(struct eth_device* dev)
        */
       rx_ring[rx_new].status &= cpu_to_le32(0x7FFFFFFF);
 //      rx_ring[rx_new].status = cpu_to_le32(RXPKT_RDY);
+      dma_flush(&rx_ring[rx_new], sizeof(rx_ring[0]));
     }
 
     /* Update entry information.
@@ -31,6 +31,7 @@
 #include <common.h>
 
 #include <command.h>
+#include <lazy_init.h>
 #include <asm/processor.h>
 #include <asm/io.h>
 #include <pci.h>
@@ -155,6 +156,7 @@ struct pci_controller *pci_bus_to_hose(int bus)
 {
 	struct pci_controller *hose;
 
+	lazy_init("pci");
 	for (hose = hose_head; hose; hose = hose->next) {
 		if (bus >= hose->first_busno && bus <= hose->last_busno)
 			return hose;
@@ -178,8 +180,10 @@ struct pci_controller *find_hose_by_cfg_addr(void *cfg_addr)
 
 int pci_last_busno(void)
 {
-	struct pci_controller *hose = hose_head;
+	struct pci_controller *hose;
 
+	lazy_init("pci");
+	hose = hose_head;
 	if (!hose)
 		return -1;
 
@@ -197,6 +201,7 @@ pci_dev_t pci_find_devices(struct pci_device_id *ids, int index)
 	pci_dev_t bdf;
 	int i, bus, found_multi = 0;
 
+	lazy_init("pci");
 	for (hose = hose_head; hose; hose = hose->next) {
 #ifdef CONFIG_SYS_SCSI_SCAN_BUS_REVERSE
 		for (bus = hose->last_busno; bus >= hose->first_busno; bus--)
@@ -112,6 +112,32 @@ void NS16550_putc(NS16550_t com_port, char c)
 		WATCHDOG_RESET();
 }
 
+#ifdef CONFIG_SYS_NS16550_TX_FIFO
+/*
+ * THRE means the whole TX FIFO is empty, so one poll of LSR buys room for
+ * CONFIG_SYS_NS16550_TX_FIFO bytes. Returns how many of buf were taken,
+ * 0 if the FIFO was still busy.
+ */
+int NS16550_putbuf(NS16550_t com_port, const char *buf, int len)
+{
+	int i;
+
+	if ((serial_in(&com_port->lsr) & UART_LSR_THRE) == 0)
+		return 0;
+
+	if (len > CONFIG_SYS_NS16550_TX_FIFO)
+		len = CONFIG_SYS_NS16550_TX_FIFO;
+	for (i = 0; i < len; i++) {
+		serial_out(buf[i], &com_port->thr);
+		/* as in NS16550_putc() */
+		if (buf[i] == '\n')
+			WATCHDOG_RESET();
+	}
+
+	return len;
+}
+#endif /* CONFIG_SYS_NS16550_TX_FIFO */
+
 #ifndef CONFIG_NS16550_MIN_FUNCTIONS
 char NS16550_getc(NS16550_t com_port)
 {
@@ -130,4 +156,15 @@ int NS16550_tstc(NS16550_t com_port)
 	return (serial_in(&com_port->lsr) & UART_LSR_DR) != 0;
 }
 
+/* Empty the RX FIFO into buf, without waiting. Returns the bytes taken. */
+int NS16550_getbuf(NS16550_t com_port, char *buf, int len)
+{
+	int i;
+
+	for (i = 0; i < len && (serial_in(&com_port->lsr) & UART_LSR_DR); i++)
+		buf[i] = serial_in(&com_port->rbr);
+
+	return i;
+}
+
 #endif /* CONFIG_NS16550_MIN_FUNCTIONS */
@@ -203,6 +203,8 @@ void serial_register(struct serial_device *dev)
 		dev->putc += gd->reloc_off;
 	if (dev->puts)
 		dev->puts += gd->reloc_off;
+	if (dev->flush)
+		dev->flush += gd->reloc_off;
 #endif
 
 	dev->next = serial_devices;
@@ -476,6 +478,24 @@ void serial_puts(const char *s)
 	get_current()->puts(s);
 }
 
+/**
+ * serial_flush() - Wait for output held back by currently selected serial port
+ *
+ * This function returns once everything written to the currently selected
+ * serial port has been handed to the hardware, for use before a reset,
+ * booting an OS or hanging. Drivers which write straight to the hardware
+ * have nothing held back and leave the flush() call unset, in which case
+ * this function does nothing. This function uses the get_current() call
+ * to determine which port is selected.
+ */
+void serial_flush(void)
+{
+	struct serial_device *dev = get_current();
+
+	if (dev->flush)
+		dev->flush();
+}
+
 /**
  * default_serial_puts() - Output string by calling serial_putc() in loop
  * @s:	Zero-terminated string to be output from the serial port.
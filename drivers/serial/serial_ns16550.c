@@ -30,6 +30,7 @@
 #endif
 
 #include <serial.h>
+#include <watchdog.h>
 
 #ifndef CONFIG_NS16550_MIN_FUNCTIONS
 
@@ -120,6 +121,10 @@ static NS16550_t serial_ports[6] = {
 	static void eserial##port##_puts(const char *s) \
 	{ \
 		serial_puts_dev(port, s); \
+	} \
+	static void eserial##port##_flush(void) \
+	{ \
+		serial_flush_dev(port); \
 	}
 
 /* Serial device descriptor */
@@ -132,6 +137,7 @@ static NS16550_t serial_ports[6] = {
 	.tstc	= eserial##port##_tstc,		\
 	.putc	= eserial##port##_putc,		\
 	.puts	= eserial##port##_puts,		\
+	.flush	= eserial##port##_flush,	\
 }
 
 static int calc_divisor (NS16550_t port)
@@ -161,9 +167,123 @@ static int calc_divisor (NS16550_t port)
 		(MODE_X_DIV * gd->baudrate);
 }
 
+#ifdef CONFIG_SYS_NS16550_RX_RING
+#ifndef CONFIG_CONS_INDEX
+#error "CONFIG_SYS_NS16550_RX_RING needs CONFIG_CONS_INDEX"
+#endif
+/*
+ * Console input is moved from the FIFO into a ring at every poll, a whole
+ * FIFO at a time, so a download only loses bytes if nothing polls the
+ * console for longer than it takes to fill the FIFO.
+ */
+#define RX_RING_MASK	(CONFIG_SYS_NS16550_RX_RING - 1)
+
+static char rx_ring[CONFIG_SYS_NS16550_RX_RING];
+static unsigned int rx_head, rx_tail;
+
+static inline int rx_ring_port(const int port)
+{
+	return port == CONFIG_CONS_INDEX && (gd->flags & GD_FLG_RELOC);
+}
+
+static void rx_ring_fill(void)
+{
+	unsigned int head, room, n;
+
+	do {
+		head = rx_head & RX_RING_MASK;
+		room = CONFIG_SYS_NS16550_RX_RING - (rx_head - rx_tail);
+		if (room > CONFIG_SYS_NS16550_RX_RING - head)
+			room = CONFIG_SYS_NS16550_RX_RING - head;
+		if (!room)
+			return;
+		n = NS16550_getbuf(serial_ports[CONFIG_CONS_INDEX - 1],
+				   rx_ring + head, room);
+		rx_head += n;
+	} while (n == room);
+}
+#else
+#define rx_ring_port(port)	0
+#define rx_ring_fill()		do { } while (0)
+#endif /* CONFIG_SYS_NS16550_RX_RING */
+
+#ifdef CONFIG_SYS_NS16550_TX_RING
+#if !defined(CONFIG_SYS_NS16550_TX_FIFO) || !defined(CONFIG_CONS_INDEX)
+#error "CONFIG_SYS_NS16550_TX_RING needs CONFIG_SYS_NS16550_TX_FIFO and CONFIG_CONS_INDEX"
+#endif
+/*
+ * Console output goes into a ring once U-Boot has relocated (.bss is not
+ * usable before that). The ring is topped up into the FIFO whenever the
+ * console is written to or polled, so the CPU only waits on the UART when
+ * the ring is full. Output that stops short of a newline is a prompt or
+ * progress text, usually followed by work that does not come back to the
+ * console for a while, so it is drained before returning.
+ */
+#define TX_RING_MASK	(CONFIG_SYS_NS16550_TX_RING - 1)
+
+static char tx_ring[CONFIG_SYS_NS16550_TX_RING];
+static unsigned int tx_head, tx_tail;
+
+static inline int tx_ring_port(const int port)
+{
+	return port == CONFIG_CONS_INDEX && (gd->flags & GD_FLG_RELOC);
+}
+
+static void tx_ring_kick(void)
+{
+	unsigned int tail = tx_tail & TX_RING_MASK;
+	unsigned int len = tx_head - tx_tail;
+
+	if (!len)
+		return;
+	if (len > CONFIG_SYS_NS16550_TX_RING - tail)
+		len = CONFIG_SYS_NS16550_TX_RING - tail;
+	tx_tail += NS16550_putbuf(serial_ports[CONFIG_CONS_INDEX - 1],
+				  tx_ring + tail, len);
+}
+
+static void tx_ring_put(const char c)
+{
+	while (tx_head - tx_tail == CONFIG_SYS_NS16550_TX_RING) {
+		tx_ring_kick();
+		rx_ring_fill();
+	}
+	tx_ring[tx_head++ & TX_RING_MASK] = c;
+}
+
+static void tx_ring_flush(void)
+{
+	while (tx_head != tx_tail)
+		tx_ring_kick();
+}
+
+/* Send what the FIFO takes now, or all of it after a partial line */
+static void tx_ring_push(const char last)
+{
+	if (last == '\n')
+		tx_ring_kick();
+	else
+		tx_ring_flush();
+}
+#else
+#define tx_ring_port(port)	0
+#define tx_ring_put(c)		do { } while (0)
+#define tx_ring_push(last)	do { } while (0)
+#define tx_ring_kick()		do { } while (0)
+#define tx_ring_flush()		do { } while (0)
+#endif /* CONFIG_SYS_NS16550_TX_RING */
+
 void
 _serial_putc(const char c,const int port)
 {
+	if (tx_ring_port(port)) {
+		if (c == '\n')
+			tx_ring_put('\r');
+		tx_ring_put(c);
+		tx_ring_push(c);
+		return;
+	}
+
 	if (c == '\n')
 		NS16550_putc(PORT, '\r');
 
@@ -173,9 +293,46 @@ _serial_putc(const char c,const int port)
 void
 _serial_putc_raw(const char c,const int port)
 {
+	if (tx_ring_port(port)) {
+		tx_ring_put(c);
+		tx_ring_push(c);
+		return;
+	}
+
 	NS16550_putc(PORT, c);
 }
 
+#ifdef CONFIG_SYS_NS16550_TX_FIFO
+/* Without the ring, still fill the whole FIFO for each wait on it */
+void
+_serial_puts (const char *s,const int port)
+{
+	char buf[CONFIG_SYS_NS16550_TX_FIFO];
+	int len, done;
+
+	if (tx_ring_port(port)) {
+		if (!*s)
+			return;
+		while (*s) {
+			if (*s == '\n')
+				tx_ring_put('\r');
+			tx_ring_put(*s++);
+		}
+		tx_ring_push(s[-1]);
+		return;
+	}
+
+	while (*s) {
+		for (len = 0; *s && len < sizeof(buf) - 1; s++) {
+			if (*s == '\n')
+				buf[len++] = '\r';
+			buf[len++] = *s;
+		}
+		for (done = 0; done < len; )
+			done += NS16550_putbuf(PORT, buf + done, len - done);
+	}
+}
+#else
 void
 _serial_puts (const char *s,const int port)
 {
@@ -183,17 +340,47 @@ _serial_puts (const char *s,const int port)
 		_serial_putc (*s++,port);
 	}
 }
+#endif /* CONFIG_SYS_NS16550_TX_FIFO */
 
 
 int
 _serial_getc(const int port)
 {
+#ifdef CONFIG_SYS_NS16550_RX_RING
+	if (rx_ring_port(port)) {
+		while (rx_head == rx_tail) {
+			tx_ring_kick();
+			rx_ring_fill();
+			WATCHDOG_RESET();
+		}
+		return (unsigned char)rx_ring[rx_tail++ & RX_RING_MASK];
+	}
+#endif
+#ifdef CONFIG_SYS_NS16550_TX_RING
+	/* waiting for input is when the ring gets drained */
+	if (tx_ring_port(port)) {
+		while (tx_head != tx_tail && !NS16550_tstc(PORT)) {
+			tx_ring_kick();
+			WATCHDOG_RESET();
+		}
+	}
+#endif
 	return NS16550_getc(PORT);
 }
 
 int
 _serial_tstc(const int port)
 {
+	if (tx_ring_port(port))
+		tx_ring_kick();
+
+#ifdef CONFIG_SYS_NS16550_RX_RING
+	if (rx_ring_port(port)) {
+		rx_ring_fill();
+		return rx_head != rx_tail;
+	}
+#endif
+
 	return NS16550_tstc(PORT);
 }
 
@@ -202,8 +389,17 @@ _serial_setbrg (const int port)
 {
 	int clock_divisor;
 
+#ifdef CONFIG_SYS_NS16550_TX_RING
+	if (tx_ring_port(port))
+		tx_ring_flush();
+#endif
 	clock_divisor = calc_divisor(PORT);
 	NS16550_reinit(PORT, clock_divisor);
+#ifdef CONFIG_SYS_NS16550_RX_RING
+	/* the FIFO was reset too; anything held came in at the old rate */
+	if (rx_ring_port(port))
+		rx_tail = rx_head;
+#endif
 }
 
 static inline void
@@ -242,6 +438,13 @@ serial_setbrg_dev(unsigned int dev_index)
 	_serial_setbrg(dev_index);
 }
 
+static inline void
+serial_flush_dev(unsigned int dev_index)
+{
+	if (tx_ring_port(dev_index))
+		tx_ring_flush();
+}
+
 #if defined(CONFIG_SYS_NS16550_COM1)
 DECLARE_ESERIAL_FUNCTIONS(1);
 struct serial_device eserial1_device =
@@ -45,6 +45,7 @@
  * VIDEO_FB_LITTLE_ENDIAN     - framebuffer organisation default: big endian
  * VIDEO_HW_RECTFILL	      - graphic driver supports hardware rectangle fill
  * VIDEO_HW_BITBLT	      - graphic driver supports hardware bit blt
+ * VIDEO_HW_MEMBLT	      - graphic driver can copy bitmaps from memory
  *
  * Console Parameters are set by graphic drivers global struct:
  *
@@ -169,6 +170,15 @@
 #endif
 #endif
 
+/*
+ * Defines for the AST2050 CRT driver, accelerated by its 2D engine
+ */
+#ifdef CONFIG_VIDEO_AST2050
+#define VIDEO_HW_RECTFILL
+#define VIDEO_HW_BITBLT
+#define VIDEO_HW_MEMBLT
+#endif
+
 /*
  * Defines for the i.MX31 driver (mx3fb.c)
  */
@@ -1783,6 +1793,29 @@ int video_display_bitmap(ulong bmp_image, int x, int y)
 			break;
 		}
 		break;
+	case 32:
+		if (VIDEO_DATA_FORMAT != GDF_32BIT_X888RGB) {
+			printf("Error: 32 bits/pixel bitmap incompatible "
+				"with current video mode\n");
+			break;
+		}
+		/* rows are stored bottom-up: start at the top one */
+		bmap += (height - 1) * padded_line;
+#ifdef VIDEO_HW_MEMBLT
+		video_hw_memblt(VIDEO_PIXEL_SIZE, bmap, -(int)padded_line,
+				x, y, width, height);
+#else
+		fb = (uchar *) (video_fb_address + y * VIDEO_LINE_LEN +
+				x * VIDEO_PIXEL_SIZE);
+		ycount = height;
+		while (ycount--) {
+			WATCHDOG_RESET();
+			memcpy(fb, bmap, width * VIDEO_PIXEL_SIZE);
+			bmap -= padded_line;
+			fb += VIDEO_LINE_LEN;
+		}
+#endif
+		break;
 	default:
 		printf("Error: %d bit/pixel bitmaps not supported by U-Boot\n",
 			le16_to_cpu(bmp->header.bit_count));
@@ -2105,7 +2138,10 @@ static int video_init(void)
 	video_init_hw_cursor(VIDEO_FONT_WIDTH, VIDEO_FONT_HEIGHT);
 #endif
 
+	/* a write-through D-cache never holds framebuffer data back */
+#ifndef CONFIG_SYS_ARM_CACHE_WRITETHROUGH
 	cfb_do_flush_cache = cfb_fb_is_in_dram() && dcache_status();
+#endif
 
 	/* Init drawing pats */
 	switch (VIDEO_DATA_FORMAT) {
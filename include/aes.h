@@ -67,4 +67,29 @@ void aes_encrypt(u8 *in, u8 *expkey, u8 *out);
  */
 void aes_decrypt(u8 *in, u8 *expkey, u8 *out);
 
+/* Block chaining modes for whole-buffer operations */
+enum aes_mode {
+	AES_MODE_ECB,
+	AES_MODE_CBC,
+	AES_MODE_CTR,
+};
+
+/**
+ * Encrypt or decrypt a buffer using a hardware engine (CONFIG_AES_HW_ACCEL)
+ *
+ * ECB and CBC need a whole number of blocks, CTR takes any length.
+ * src and dst may be the same buffer.
+ *
+ * mode		Chaining mode
+ * encrypt	Non-zero to encrypt, zero to decrypt
+ * key		Key, of length AES_KEY_LENGTH bytes
+ * iv		Initial vector or counter block (unused for ECB)
+ * src		Input data
+ * dst		Output data
+ * len		Length of data in bytes
+ * return 0 if ok, -ve on error
+ */
+int hw_aes_crypt(enum aes_mode mode, int encrypt, u8 *key, u8 *iv,
+		 const void *src, void *dst, unsigned int len);
+
 #endif /* _AES_REF_H_ */
@@ -37,6 +37,9 @@
  */
 
 #ifndef __ASSEMBLY__
+/* board_init_f() steps whose times are kept for bootstage */
+#define GD_INIT_F_STEPS	24
+
 typedef struct global_data {
 	bd_t *bd;
 	unsigned long flags;
@@ -84,6 +87,10 @@ typedef struct global_data {
 	char env_buf[32];	/* buffer for getenv() before reloc. */
 #ifdef CONFIG_TRACE
 	void		*trace_buff;	/* The trace buffer */
+#endif
+#ifdef CONFIG_BOOTSTAGE
+	/* When each board_init_f() step finished, until bootstage is usable */
+	unsigned long init_f_us[GD_INIT_F_STEPS];
 #endif
 	struct arch_global_data arch;	/* architecture-specific data */
 } gd_t;
@@ -0,0 +1,99 @@
+/*
+ * Preparing the autoboot kernel while the boot delay counts down
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#ifndef __BOOT_PREP_H
+#define __BOOT_PREP_H
+
+#include <errno.h>
+#include <image.h>
+
+#ifdef CONFIG_BOOT_PREPARE
+/**
+ * Start preparing the kernel a boot command would boot
+ *
+ * Only a plain "bootm [addr ...]" is understood. The legacy kernel image
+ * it names is checked and then, one boot_prep_step() at a time, its data
+ * CRC verified (if $verify allows) and its data copied or gunzipped to
+ * the load address, as bootm would.
+ *
+ * @param cmd	Boot command
+ * @return 0 if preparation started, -ve if there is nothing to prepare
+ */
+int boot_prep_cmd(const char *cmd);
+
+/**
+ * Start preparing a legacy kernel image
+ *
+ * @param img_addr	Address of the image header
+ * @return 0 if preparation started, -EINVAL if the image is not a legacy
+ * kernel, or is XIP or would be overwritten while it is unpacked,
+ * -EOPNOTSUPP if its compression can't be done in steps
+ */
+int boot_prep_start(ulong img_addr);
+
+/**
+ * Do a slice of the preparation, a few milliseconds' work at most
+ *
+ * @return 1 if work was done, 0 if there is none left
+ */
+int boot_prep_step(void);
+
+/**
+ * Complete the preparation of an image, if it was started
+ *
+ * @param hdr		Image header bootm is booting
+ * @param load_end	If not NULL, receives the end of the loaded data
+ * @return 0 if the image is loaded, -ENOENT if it is not the image that
+ * was being prepared (or its header has changed since), -EIO if
+ * preparing it failed
+ */
+int boot_prep_finish(const image_header_t *hdr, ulong *load_end);
+
+/**
+ * Tell whether the data CRC of an image was checked while preparing it
+ *
+ * @param hdr	Image header bootm is booting
+ * @return 1 if the CRC was checked and matched, else 0
+ */
+int boot_prep_verified(const image_header_t *hdr);
+
+/**
+ * Stop preparing and forget the image
+ *
+ * Whatever was already written to the load address is left there, but
+ * bootm will no longer trust it.
+ */
+void boot_prep_cancel(void);
+#else
+static inline int boot_prep_cmd(const char *cmd)
+{
+	return -ENOSYS;
+}
+
+static inline int boot_prep_step(void)
+{
+	return 0;
+}
+
+static inline void boot_prep_cancel(void)
+{
+}
+#endif
+
+#endif /* __BOOT_PREP_H */
@@ -335,6 +335,32 @@ int update_flash_size(int flash_size);
  */
 void board_show_dram(ulong size);
 
+/**
+ * Run the bulk pattern passes of mtest on a hardware engine
+ *
+ * Boards with a DRAM controller that can test memory by itself provide
+ * this. The CPU still does the data and address line tests.
+ *
+ * @param start_addr	First byte to test
+ * @param end_addr	End of the range (exclusive)
+ * @param pattern	Seed for the patterns
+ * @param errs		Receives the number of errors, or -1UL if interrupted
+ * @return 0 if the range was tested, -ENOSYS to test it with the CPU
+ */
+int mem_test_hw(ulong start_addr, ulong end_addr, ulong pattern, ulong *errs);
+
+/**
+ * Check that mtest may overwrite a range
+ *
+ * Provided where U-Boot keeps something in DRAM that mtest would
+ * otherwise destroy, such as exception vectors.
+ *
+ * @param start_addr	First byte to test
+ * @param end_addr	End of the range (exclusive)
+ * @return 0 if ok, -EBUSY if the range is in use
+ */
+int mem_test_check(ulong start_addr, ulong end_addr);
+
 /**
  * arch_fixup_memory_node() - Write arch-specific memory information to fdt
  *
@@ -649,6 +675,7 @@ void	serial_setbrg (void);
 void	serial_putc   (const char);
 void	serial_putc_raw(const char);
 void	serial_puts   (const char *);
+void	serial_flush  (void);
 int	serial_getc   (void);
 int	serial_tstc   (void);
 
@@ -791,11 +818,14 @@ void	wait_ticks    (unsigned long);
 
 /* arch/$(ARCH)/lib/time.c */
 void	__udelay      (unsigned long);
+void	__ndelay      (unsigned long);
 ulong	usec2ticks    (unsigned long usec);
 ulong	ticks2usec    (unsigned long ticks);
 int	init_timebase (void);
 
 /* lib/gunzip.c */
+/* Returns the offset of the deflate stream in a gzip file, or -1 */
+int gzip_parse_header(const unsigned char *src, unsigned long len);
 int gunzip(void *, int, unsigned char *, unsigned long *);
 int zunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
 						int stoponerr, int offset);
@@ -807,6 +837,7 @@ int strcmp_compar(const void *, const void *);
 
 /* lib/time.c */
 void	udelay        (unsigned long);
+void	ndelay        (unsigned long);
 void mdelay(unsigned long);
 
 /* lib/uuid.c */
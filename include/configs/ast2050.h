@@ -86,6 +86,10 @@
  */
 #define CPU_CLOCK_RATE		18000000	/* 16.5 MHz clock for the ARM core */
 
+/* ARM optimised string routines, which handle misaligned copies */
+#define CONFIG_USE_ARCH_MEMCPY
+#define CONFIG_USE_ARCH_MEMSET
+
 /*
  * Size of malloc() pool
  */
@@ -45,7 +45,7 @@
 //#define CONFIG_FLASH_SPIx4_Dummy
 #define CONFIG_CRT_DISPLAY	1		/* undef if not support CRT */
 
-//#define CONFIG_USE_IRQ				/* we don't need IRQ/FIQ stuff */
+//#define CONFIG_USE_IRQ			/* only for the profiler, below */
 #define CONFIG_MISC_INIT_R
 
 /*
@@ -53,10 +53,15 @@
  * 1. UART Debug Message
  *    CONFIG_DRAM_UART_OUT   // enable output message at UART5
  *    CONFIG_DRAM_UART_38400 // set the UART baud rate to 38400, default is 115200
+ * 2. Geometry, probed at run time unless forced
+ *    CONFIG_1G_DDRII / CONFIG_512M_DDRII
+ * 3. Read delay, swept at every boot unless the table default is wanted
+ *    CONFIG_DDRII_DEFAULT_DELAY
  */
 
-#define CONFIG_512M_DDRII
+// #define CONFIG_512M_DDRII
 // #define CONFIG_1G_DDRII
+// #define CONFIG_DDRII_DEFAULT_DELAY
 
 //1. UART Debug Message
 #define    CONFIG_DRAM_UART_OUT
@@ -78,6 +83,7 @@
 	"autoboot in %d seconds (stop with 'Delete' key)...\n", bootdelay
 #define CONFIG_AUTOBOOT_STOP_STR	"\x1b\x5b\x33\x7e" /* 'Delete', ESC[3~ */
 #define CONFIG_ZERO_BOOTDELAY_CHECK
+#define CONFIG_BOOT_PREPARE		/* unpack the kernel during the delay */
 
 #ifdef CONFIG_FLASH_AST2300
 #define CONFIG_BOOTCOMMAND	"bootm 20080000"
@@ -107,12 +113,69 @@
 #define CONFIG_CMD_EEPROM
 #define CONFIG_CMD_NETTEST
 #define CONFIG_CMD_SLT
+#define CONFIG_CMD_DRAMPERF
+#define CONFIG_CMD_MEMTEST
+#define CONFIG_CMD_DELAYTEST
+#define CONFIG_CMD_CACHE
+#define CONFIG_CMD_BOOTSTAGE
+
+/*
+ * Boot time profile: every init step is timed for "bootstage report",
+ * and the table goes to the kernel in the device tree or, for a kernel
+ * booted with ATAGs, in SRAM above the DDR2 init stack.
+ */
+#define CONFIG_BOOTSTAGE
+#define CONFIG_BOOTSTAGE_USER_COUNT	48
+#define CONFIG_BOOTSTAGE_FDT
+#define CONFIG_BOOTSTAGE_STASH		0x1E721000
+#define CONFIG_BOOTSTAGE_STASH_SIZE	0x1000
+
+/* Flash, PCI and network are probed on first use, not at every boot */
+#define CONFIG_LAZY_INIT
+#define CONFIG_CMD_LAZYINIT
+
+/*
+ * Function trace, with "make FTRACE=1". There is no early trace: until it
+ * relocates U-Boot runs from flash, where the trace state can't be kept.
+ */
+#ifdef FTRACE
+#define CONFIG_TRACE
+#define CONFIG_CMD_TRACE
+#define CONFIG_TRACE_BUFFER_SIZE	(4 << 20)
+#define CONFIG_TRACE_CALL_DEPTH_LIMIT	30
+#endif
+
+/*
+ * Sampling profiler, in the asus_profile build: "profile start", then
+ * "profile report". Timer2 raises the samples, so this is the one build
+ * that takes interrupts, through vectors copied to the start of DRAM.
+ */
+#ifdef CONFIG_AST_PROFILE
+#define CONFIG_USE_IRQ
+#define CONFIG_PROFILE
+#define CONFIG_CMD_PROFILE
+#define CONFIG_PROFILE_HZ		1000
+#endif
+
+/* saveenv lays out the hash table, so the boot needn't parse the env */
+#define CONFIG_ENV_INDEX
 
 /*
  * CPU Setting
  */
 #define CPU_CLOCK_RATE		18000000	/* 16.5 MHz clock for the ARM core */
 
+/* ARM optimised string routines, which handle misaligned copies */
+#define CONFIG_USE_ARCH_MEMCPY
+#define CONFIG_USE_ARCH_MEMSET
+
+/*
+ * Cache: the MAC packs 16 byte descriptors two to a cache line, which
+ * only stays coherent if the CPU never holds dirty lines over them.
+ */
+#define CONFIG_SYS_CACHELINE_SIZE	32
+#define CONFIG_SYS_ARM_CACHE_WRITETHROUGH
+
 /*
  * Size of malloc() pool
  */
@@ -135,6 +198,13 @@
 
 #define CONFIG_SYS_SDRAM_BASE	0x40000000
 
+/*
+ * Hidden from U-Boot at the top of DRAM, under the VGA memory: the CRT
+ * frame buffer (2MB) and above it the video engine buffers (15MB). Both
+ * are placed from gd->ram_size, which no longer includes them.
+ */
+#define CONFIG_SYS_MEM_TOP_HIDE	(17 << 20)
+
 /*
  * FLASH Configuration
  */
@@ -190,7 +260,12 @@
 
 #define CONFIG_ENV_IS_IN_FLASH		1
 #define CONFIG_ENV_OFFSET		0x60000 	/* environment starts here  */
-#define CONFIG_ENV_SIZE			0x20000 	/* Total Size of Environment Sector */
+#define CONFIG_ENV_OFFSET_REDUND	0x40000 	/* and its other copy */
+/* the build fails if u-boot.bin runs into the lower copy */
+#define CONFIG_BOARD_SIZE_LIMIT		CONFIG_ENV_OFFSET_REDUND
+#define CONFIG_ENV_SECT_SIZE		0x20000 	/* Total Size of Environment Sector */
+#define CONFIG_ENV_SIZE			0x10000 	/* the rest holds the log */
+#define CONFIG_ENV_LOG					/* saveenv appends changes */
 #define CONFIG_ASPEED_WRITE_DEFAULT_ENV
 #endif
 
@@ -216,10 +291,16 @@
 #define CONFIG_SYS_MAXARGS		16		/* max number of command args	*/
 #define CONFIG_SYS_BARGSIZE		CONFIG_SYS_CBSIZE	/* Boot Argument Buffer Size	*/
 
-#define CONFIG_SYS_MEMTEST_START	0x40000000	/* memtest works on	*/
-#define CONFIG_SYS_MEMTEST_END		0x44FFFFFF	/* 256 MB in DRAM	*/
+/*
+ * memtest works on the DRAM above the vectors and below U-Boot's stack.
+ * Where U-Boot relocated to depends on the RAM found and the buffers
+ * reserved above it, so the end is worked out at run time.
+ */
+#define CONFIG_SYS_MEMTEST_START	0x40001000
+#define CONFIG_SYS_MEMTEST_END		(gd->start_addr_sp - CONFIG_STACKSIZE)
+#define CONFIG_SYS_ALT_MEMTEST
 
-#define CONFIG_SYS_LOAD_ADDR		0x43000000	/* default load address */
+#define CONFIG_SYS_LOAD_ADDR		0x40800000	/* default load address */
 
 #define CONFIG_SYS_TIMERBASE		0x1E782000	/* use timer 1 */
 #define CONFIG_SYS_HZ			      1000
@@ -235,10 +316,19 @@
 #define CONFIG_SYS_NS16550_CLK		24000000
 #define CONFIG_SYS_NS16550_COM1		0x1e783000
 #define CONFIG_SYS_NS16550_COM2		0x1e784000
+#define CONFIG_SYS_NS16550_TX_FIFO	16	/* bytes per THRE wait */
+#define CONFIG_SYS_NS16550_TX_RING	4096	/* console output backlog */
+#define CONFIG_SYS_NS16550_RX_RING	4096	/* console input backlog */
 #define	CONFIG_SYS_LOADS_BAUD_CHANGE
 #define CONFIG_CONS_INDEX		2
 #define CONFIG_BAUDRATE			38400
-#define CONFIG_SYS_BAUDRATE_TABLE	{ 9600, 19200, 38400, 57600, 115200 }
+/*
+ * Above 115200 the standard rates are more than 5% off with a 24MHz
+ * clock, so offer what divides it exactly: 375000 ... 1500000.
+ */
+#define CONFIG_SYS_BAUDRATE_TABLE	{ 9600, 19200, 38400, 57600, 115200, \
+	CONFIG_SYS_NS16550_CLK / 16 / 4, CONFIG_SYS_NS16550_CLK / 16 / 3, \
+	CONFIG_SYS_NS16550_CLK / 16 / 2, CONFIG_SYS_NS16550_CLK / 16 }
 #define CONFIG_ASPEED_COM CONFIG_SYS_NS16550_COM2
 #define CONFIG_ASPEED_COM_IER (CONFIG_ASPEED_COM + 0x4)
 #define CONFIG_ASPEED_COM_IIR (CONFIG_ASPEED_COM + 0x8)
@@ -338,6 +428,56 @@
 //#define CONFIG_IPADDR    192.168.0.45
 //#define CONFIG_SERVERIP  192.168.0.81
 
+/*
+ * Hash and crypto engine
+ */
+#define CONFIG_ASPEED_HACE
+#define CONFIG_SHA_HW_ACCEL
+#define CONFIG_MD5_HW_ACCEL
+#define CONFIG_SHA1				/* software fallback */
+#define CONFIG_SHA256
+#define CONFIG_MD5
+#define CONFIG_CMD_HASH
+#define CONFIG_AES				/* key schedule */
+#define CONFIG_AES_HW_ACCEL
+#define CONFIG_CMD_AES
+
+/*
+ * FIT images. Encrypted ones (CONFIG_FIT_CIPHER) need the board to supply
+ * the key with board_fit_cipher_key(), and the AST2050 has no OTP or other
+ * place to keep one secret, so they are left off.
+ */
+#define CONFIG_FIT
+#define CONFIG_OF_LIBFDT
+/* #define CONFIG_FIT_CIPHER */
+
+/*
+ * Framebuffer console and splash screen on the CRT (local VGA port),
+ * 800x600x32 in the DRAM hidden above U-Boot
+ */
+#define CONFIG_VIDEO
+#define CONFIG_VIDEO_AST2050
+#define CONFIG_ASPEED_FB_ADDR		(CONFIG_SYS_SDRAM_BASE + gd->ram_size)
+#define CONFIG_CFB_CONSOLE
+#define CONFIG_VGA_AS_SINGLE_DEVICE
+#define CONFIG_SPLASH_SCREEN
+#define CONFIG_SPLASH_SCREEN_ALIGN
+#define CONFIG_CMD_BMP
+
+/*
+ * Video capture and compression (vcap command), with frames uploaded
+ * by tftpput. The engine buffers take just over 14MB of the
+ * DRAM hidden above U-Boot.
+ */
+#define CONFIG_ASPEED_VIDEO_CAPTURE
+#define CONFIG_ASPEED_VIDEO_BUF		(CONFIG_ASPEED_FB_ADDR + (2 << 20))
+#define CONFIG_CMD_TFTPPUT
+
+/*
+ * MIC engine watching loaded images until bootm (mic command)
+ */
+#define CONFIG_ASPEED_MIC
+
 /*
  * SLT
  */
@@ -29,12 +29,17 @@
 #define CONFIG_TRACE_EARLY_SIZE		(8 << 20)
 #define CONFIG_TRACE_EARLY
 #define CONFIG_TRACE_EARLY_ADDR		0x00100000
+#define CONFIG_TRACE_CALL_DEPTH_LIMIT	30
 
 #endif
 
 #define CONFIG_BOOTSTAGE
 #define CONFIG_BOOTSTAGE_REPORT
 
+/* Sampling profiler, driven by a SIGPROF timer */
+#define CONFIG_PROFILE
+#define CONFIG_CMD_PROFILE
+
 /* Number of bits in a C 'long' on this architecture */
 #define CONFIG_SANDBOX_BITS_PER_LONG	64
 
@@ -81,6 +86,7 @@
 
 #define CONFIG_ENV_SIZE		8192
 #define CONFIG_ENV_IS_NOWHERE
+#define CONFIG_ENV_INDEX
 
 #define CONFIG_SYS_HZ			1000
 
@@ -118,6 +124,8 @@
 #define CONFIG_SHA256
 
 #define CONFIG_CMD_SANDBOX
+#define CONFIG_CMD_DELAYTEST
+#define CONFIG_UT_STRING
 
 #define CONFIG_BOOTARGS ""
 
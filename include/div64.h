@@ -39,7 +39,8 @@ extern uint32_t __div64_32(uint64_t *dividend, uint32_t divisor);
 /* Wrapper for do_div(). Doesn't modify dividend and returns
  * the result, not reminder.
  */
-static inline uint64_t lldiv(uint64_t dividend, uint32_t divisor)
+static inline uint64_t __attribute__((no_instrument_function))
+lldiv(uint64_t dividend, uint32_t divisor)
 {
 	uint64_t __res = dividend;
 	do_div(__res, divisor);
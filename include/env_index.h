@@ -0,0 +1,100 @@
+/*
+ * Prebuilt hash table index for the environment
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#ifndef __ENV_INDEX_H
+#define __ENV_INDEX_H
+
+/*
+ * saveenv (and mkenvimage -i) can record, at the very end of the
+ * environment data, which hash table slot each variable goes in. The
+ * environment CRC covers it as usual. Older U-Boots stop reading at the
+ * empty string which ends the variables and never see it. It also keeps
+ * a CRC of the variables it was built for, so that one left behind by a
+ * tool which changed them (an older fw_setenv) is not used.
+ *
+ * The layout is: the variables, free space, count entries, the header.
+ * All fields are little-endian.
+ */
+#define ENV_INDEX_MAGIC		0x58444945	/* "EIDX" */
+#define ENV_INDEX_VERSION	3		/* bump when the hash changes */
+
+#define ENV_INDEX_ESCAPED	(1U << 31)	/* in value: has '\' escapes */
+
+struct env_index_ent {
+	uint32_t hval;		/* env_hash() of the name */
+	uint32_t slot;		/* table slot, 1 ... size */
+	uint32_t key;		/* offset of "name=value" in the data */
+	uint32_t value;		/* offset of the value, | ENV_INDEX_ESCAPED */
+};
+
+struct env_index_hdr {
+	uint32_t len;		/* bytes of variables, with the final "\0\0" */
+	uint32_t crc;		/* crc32() of those bytes */
+	uint32_t size;		/* hash table size, a power of two */
+	uint32_t count;		/* entries */
+	uint32_t version;
+	uint32_t magic;
+};
+
+/*
+ * Hash of a variable name. The low bits pick the first table slot tried.
+ * lib/hashtable.c uses this too, so that the two agree.
+ */
+static inline unsigned int env_hash(const char *key)
+{
+	unsigned int hval = 0;
+
+	while (*key)
+		hval = hval * 31 + (unsigned char)*key++;
+
+	/* Mix the high bits into the low ones, which pick the slot */
+	hval ^= hval >> 16;
+	hval *= 0x85ebca6b;
+	hval ^= hval >> 13;
+
+	return hval;
+}
+
+/**
+ * Add an index to exported environment data
+ *
+ * @param env	Variables as written by hexport_r() with '\0' separators
+ * @param size	Size of the environment data area
+ * @param nel	Hash table size to lay out for; rounded up to a power of
+ *		two, and doubled while the variables fill over 3/4 of it
+ * @return 0 if OK, -ENOSPC if the index doesn't fit after the variables,
+ * -EINVAL if the data is not something himport_r() takes as it is, or
+ * -ENOMEM
+ */
+int env_index_build(char *env, size_t size, unsigned int nel);
+
+/**
+ * Find the index in environment data
+ *
+ * @param env	Environment data
+ * @param size	Size of the environment data area
+ * @param hdr	Returns the header, in CPU byte order
+ * @return pointer to the first struct env_index_ent (little-endian and
+ * perhaps not aligned), or NULL if there is no usable index, or it was
+ * built for other variables
+ */
+const void *env_index_find(const char *env, size_t size,
+			   struct env_index_hdr *hdr);
+
+#endif /* __ENV_INDEX_H */
@@ -47,4 +47,15 @@ void hw_sha256(const uchar * in_addr, uint buflen,
  */
 void hw_sha1(const uchar * in_addr, uint buflen,
 			uchar * out_addr, uint chunk_size);
+
+/**
+ * Computes MD5 hash value of input pbuf using h/w acceleration
+ *
+ * @param in_addr	A pointer to the input buffer
+ * @param buflen	Byte length of input buffer
+ * @param out_addr	A pointer to the output buffer, 16 bytes are written
+ * @param chunk_size	chunk_size for md5
+ */
+void hw_md5(const uchar *in_addr, uint buflen,
+			uchar *out_addr, uint chunk_size);
 #endif
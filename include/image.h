@@ -458,6 +458,21 @@ int fit_image_load(bootm_headers_t *images, const char *prop_name, ulong addr,
 		   int arch, int image_type, int bootstage_id,
 		   enum fit_load_op load_op, ulong *datap, ulong *lenp);
 
+/**
+ * board_fit_cipher_key() - Find the key for an encrypted FIT image
+ *
+ * Boards which boot encrypted images must override this weak function.
+ * The default has no key, unless CONFIG_FIT_CIPHER_KEY_ENV lets it read
+ * one as a hex string from the environment variable of the same name.
+ *
+ * @param name		Key name, from the cipher node's key-name-hint
+ * @param key		Buffer for the key
+ * @param len		Key length in bytes
+ * @return 0 if ok, -ENOENT if there is no such key, -ENOSYS if the board
+ * keeps no keys
+ */
+int board_fit_cipher_key(const char *name, u8 *key, int len);
+
 /**
  * fit_get_node_from_config() - Look up an image a FIT by type
  *
@@ -689,8 +704,14 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 #define FIT_IGNORE_PROP		"uboot-ignore"
 #define FIT_SIG_NODENAME	"signature"
 
+/* cipher node */
+#define FIT_CIPHER_NODENAME	"cipher"
+#define FIT_IV_PROP		"iv"
+#define FIT_KEY_HINT		"key-name-hint"
+
 /* image node */
 #define FIT_DATA_PROP		"data"
+#define FIT_DATA_SIZE_UNCIPHERED_PROP	"data-size-unciphered"
 #define FIT_TIMESTAMP_PROP	"timestamp"
 #define FIT_DESC_PROP		"description"
 #define FIT_ARCH_PROP		"arch"
@@ -0,0 +1,88 @@
+/*
+ * Subsystems initialised on first use instead of in board_init_r()
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#ifndef __LAZY_INIT_H
+#define __LAZY_INIT_H
+
+#include <linker_lists.h>
+
+enum lazy_init_state {
+	LAZY_INIT_PENDING,
+	LAZY_INIT_RUNNING,
+	LAZY_INIT_DONE,
+};
+
+struct lazy_init {
+	const char *name;
+	int (*init)(void);		/* returns 0 or -ve error */
+	enum lazy_init_state state;
+	int ret;			/* what init() returned */
+	ulong us;			/* and how long it took */
+};
+
+#ifdef CONFIG_LAZY_INIT
+/*
+ * Register init as the one-time setup of the subsystem called name. It
+ * runs the first time lazy_init(name) is called, from the subsystem's
+ * entry points, or from the lazyinit command.
+ */
+#define U_BOOT_LAZY_INIT(_name, _init) \
+	ll_entry_declare(struct lazy_init, _name, lazy_init) = \
+	{#_name, _init, LAZY_INIT_PENDING}
+
+/**
+ * Make sure a subsystem has been initialised
+ *
+ * Runs the init function registered for name, unless it has run already.
+ * A call made while it is running (e.g. from the driver it probes) returns
+ * straight away. Nothing is registered for subsystems that were set up at
+ * boot, so callers need not know which is the case.
+ *
+ * @param name	Name given to U_BOOT_LAZY_INIT()
+ * @return 0 if the subsystem is ready, else what its init function returned
+ */
+int lazy_init(const char *name);
+
+/**
+ * Find the entry registered for a subsystem
+ *
+ * @param name	Name given to U_BOOT_LAZY_INIT()
+ * @return the entry, or NULL if there is none
+ */
+struct lazy_init *lazy_init_find(const char *name);
+
+/**
+ * Print each registered subsystem, whether it was initialised and how
+ * long that took
+ */
+void lazy_init_report(void);
+#else
+#define U_BOOT_LAZY_INIT(_name, _init) \
+	static inline void _u_boot_lazy_init_noop_##_name(void) \
+	{ \
+		(void)_init; \
+	}
+
+static inline int lazy_init(const char *name)
+{
+	return 0;
+}
+#endif
+
+#endif /* __LAZY_INIT_H */
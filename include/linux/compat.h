@@ -1,8 +1,6 @@
 #ifndef _LINUX_COMPAT_H_
 #define _LINUX_COMPAT_H_
 
-#define ndelay(x)	udelay(1)
-
 #define printk	printf
 
 #define KERN_EMERG
@@ -176,3 +176,5 @@ void NS16550_putc(NS16550_t com_port, char c);
 char NS16550_getc(NS16550_t com_port);
 int NS16550_tstc(NS16550_t com_port);
 void NS16550_reinit(NS16550_t com_port, int baud_divisor);
+int NS16550_putbuf(NS16550_t com_port, const char *buf, int len);
+int NS16550_getbuf(NS16550_t com_port, char *buf, int len);
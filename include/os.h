@@ -134,6 +134,18 @@ void os_usleep(unsigned long usec);
  */
 u64 os_get_nsec(void);
 
+/**
+ * Call a function at a steady rate while the process is using the CPU
+ *
+ * The function is called from a signal handler, so it must not do more
+ * than update memory. Only one such timer can run at a time.
+ *
+ * \param hz	Calls per second of CPU time, or 0 to stop the timer
+ * \param func	Function to call with the interrupted program counter
+ * \return 0 if OK, -1 on error
+ */
+int os_profile_timer(unsigned int hz, void (*func)(unsigned long pc));
+
 /**
  * Parse arguments and update sandbox state.
  *
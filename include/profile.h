@@ -0,0 +1,75 @@
+/*
+ * Sampling profiler
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+/**
+ * Start taking samples
+ *
+ * A timer interrupt records where the CPU was at each tick, until
+ * profile_stop(). Samples add to those already taken, until
+ * profile_clear().
+ *
+ * @param hz	Samples per second, or 0 for CONFIG_PROFILE_HZ
+ * @return 0 if OK, -ENOMEM if there is no room for the histogram, or
+ * whatever the timer driver returned
+ */
+int profile_start(unsigned int hz);
+
+/* Stop taking samples */
+void profile_stop(void);
+
+/* Throw away the samples taken so far */
+void profile_clear(void);
+
+/**
+ * Record one sample. This is called by the timer driver from its
+ * interrupt handler.
+ *
+ * @param pc		Address of the interrupted instruction
+ * @param caller	Return address of the interrupted function, or 0 if
+ *			it is not known
+ */
+void profile_sample(ulong pc, ulong caller);
+
+/**
+ * Count the samples taken in a range of code
+ *
+ * @param start		First address in the range
+ * @param end		Address just after the range
+ * @return number of samples whose pc was in the range
+ */
+ulong profile_count(ulong start, ulong end);
+
+/**
+ * Print the functions in which most samples were taken
+ *
+ * @param max_lines	Number of functions to list
+ */
+void profile_report(int max_lines);
+
+/*
+ * The timer driver provides these. profile_timer_start() must arrange for
+ * profile_sample() to be called hz times a second.
+ */
+int profile_timer_start(unsigned int hz);
+void profile_timer_stop(void);
+
+#endif /* __PROFILE_H */
@@ -66,6 +66,11 @@ struct hsearch_data {
 	struct _ENTRY *table;
 	unsigned int size;
 	unsigned int filled;
+	/* Data imported with an index, which entries may point into */
+	char *image;
+	size_t image_len;
+	/* The entries in key order, or NULL until hmatch_r() needs them */
+	ENTRY **sorted;
 /*
  * Callback function which will check whether the given change for variable
  * "item" to "newval" may be applied or not, and possibly apply such change.
@@ -77,7 +82,7 @@ struct hsearch_data {
 		int flag);
 };
 
-/* Create a new hashing table which will at most contain NEL elements.  */
+/* Create a new hashing table sized for NEL elements, which grows as needed. */
 extern int hcreate_r(size_t __nel, struct hsearch_data *__htab);
 
 /* Destroy current internal hashing table.  */
@@ -93,8 +98,9 @@ extern int hsearch_r(ENTRY __item, ACTION __action, ENTRY ** __retval,
 		     struct hsearch_data *__htab, int __flag);
 
 /*
- * Search for an entry matching `MATCH'.  Otherwise, Same semantics
- * as hsearch_r().
+ * Search for an entry whose key starts with `MATCH', in key order.  Pass
+ * 0 as `LAST_IDX' for the first one and then the value returned, which
+ * is 0 when there are no more.
  */
 extern int hmatch_r(const char *__match, int __last_idx, ENTRY ** __retval,
 		    struct hsearch_data *__htab);
@@ -14,6 +14,7 @@ struct serial_device {
 	int	(*tstc)(void);
 	void	(*putc)(const char c);
 	void	(*puts)(const char *s);
+	void	(*flush)(void);		/* optional */
 #if CONFIG_POST & CONFIG_SYS_POST_UART
 	void	(*loop)(int);
 #endif
@@ -0,0 +1,77 @@
+/*
+ * Timebase arithmetic shared by the timer drivers' delay code. These
+ * helpers depend only on their arguments, so the tick rounding and the
+ * counter wrap handling can be checked in sandbox (see test/time_ut.c).
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#ifndef _TIMEBASE_H
+#define _TIMEBASE_H
+
+#include <div64.h>
+
+/**
+ * Convert a delay in microseconds into timebase ticks
+ *
+ * The result is rounded up, so waiting for it never waits less than asked.
+ *
+ * @param usec	Delay in microseconds
+ * @param rate	Timebase rate in Hz
+ * @return number of ticks
+ */
+static inline uint64_t timebase_from_usec(unsigned long usec,
+					  unsigned long rate)
+{
+	uint64_t tick = (uint64_t)usec * rate + 999999;
+
+	do_div(tick, 1000000);
+	return tick;
+}
+
+/**
+ * Convert a delay in nanoseconds into timebase ticks, rounding up
+ *
+ * @param nsec	Delay in nanoseconds
+ * @param rate	Timebase rate in Hz
+ * @return number of ticks
+ */
+static inline uint64_t timebase_from_nsec(unsigned long nsec,
+					  unsigned long rate)
+{
+	uint64_t tick = (uint64_t)nsec * rate + 999999999;
+
+	do_div(tick, 1000000000);
+	return tick;
+}
+
+/**
+ * Return the ticks elapsed between two readings of a down counter
+ *
+ * The counter must be reloaded with 0xffffffff, giving it a period of
+ * exactly 2^32 ticks, and be read at least once per period.
+ *
+ * @param last	Earlier reading
+ * @param now	Later reading
+ * @return number of ticks elapsed
+ */
+static inline uint32_t __attribute__((no_instrument_function))
+timebase_down_elapsed(uint32_t last, uint32_t now)
+{
+	return last - now;
+}
+
+#endif /* _TIMEBASE_H */
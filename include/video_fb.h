@@ -101,6 +101,18 @@ void video_hw_rectfill (
      );
 #endif
 
+#ifdef VIDEO_HW_MEMBLT
+void video_hw_memblt (
+    unsigned int bpp,             /* bytes per pixel */
+    const void *src,              /* first source row */
+    int src_pitch,                /* bytes to next row, may be negative */
+    unsigned int dst_x,           /* dest pos x */
+    unsigned int dst_y,           /* dest pos y */
+    unsigned int dim_x,           /* frame width */
+    unsigned int dim_y            /* frame height */
+    );
+#endif
+
 void video_set_lut (
     unsigned int index,           /* color number */
     unsigned char r,              /* red */
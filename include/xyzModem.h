@@ -62,6 +62,7 @@
 #define xyzModem_ymodem 2
 /* Don't define this until the protocol support is in place */
 /*#define xyzModem_zmodem 3 */
+#define xyzModem_ymodem_g 4	/* Y-modem streaming: no ACK per block */
 
 #define xyzModem_access   -1
 #define xyzModem_noZmodem -2
@@ -18,7 +18,8 @@
 
 #include <linux/types.h>
 
-uint32_t __div64_32(uint64_t *n, uint32_t base)
+uint32_t __attribute__((no_instrument_function))
+__div64_32(uint64_t *n, uint32_t base)
 {
 	uint64_t rem = *n;
 	uint64_t b = base;
@@ -0,0 +1,191 @@
+/*
+ * Prebuilt hash table index for the environment
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Importing the environment means parsing every "name=value", hashing
+ * the name and copying both into the table with strdup(). With an index
+ * himport_r() instead copies the variables once, puts each in the slot
+ * the index gives and points the entry into that copy. This file builds
+ * the index, in U-Boot for saveenv and on the host for mkenvimage.
+ */
+
+#ifdef USE_HOSTCC
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#else
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#endif
+#include <compiler.h>
+#include <env_index.h>
+#include <u-boot/crc.h>
+
+/* A slot of the table being laid out, as _ENTRY in lib/hashtable.c */
+struct env_index_slot {
+	unsigned int used;	/* distance from home + 1, or 0 if free */
+	unsigned int hval;
+	unsigned int n;		/* which variable */
+};
+
+/* Compare the names of two "name=value" strings */
+static int same_name(const char *a, const char *b)
+{
+	while (*a == *b && *a != '=') {
+		a++;
+		b++;
+	}
+
+	return *a == '=' && *b == '=';
+}
+
+int env_index_build(char *env, size_t size, unsigned int nel)
+{
+	struct env_index_ent ent;
+	struct env_index_hdr hdr;
+	struct env_index_slot *slots, cur, tmp;
+	unsigned int *where;	/* offset of each variable */
+	unsigned int count, n, idx;
+	char *p, *eq, *list;
+	size_t len, room;
+
+	/* Only plain "name=value" strings: anything else needs himport_r() */
+	for (p = env, count = 0; p < env + size && *p; p += len + 1, count++) {
+		len = strnlen(p, env + size - p);
+		if (p + len == env + size)
+			return -EINVAL;
+		eq = memchr(p, '=', len);
+		if (!eq || eq == p || eq == p + len - 1 || *p == ' ' ||
+		    *p == '\t' || *p == '#')
+			return -EINVAL;
+	}
+	if (p == env + size)
+		return -EINVAL;
+	len = p + 1 - env;
+
+	/* As hcreate_r(), and as the table would grow */
+	for (n = 8; n < nel || count * 4 > n * 3; n <<= 1)
+		;
+	nel = n;
+	room = count * sizeof(ent) + sizeof(hdr);
+	if (len + room > size)
+		return -ENOSPC;
+	list = env + size - room;
+
+	slots = calloc(nel + 1, sizeof(*slots));
+	where = calloc(count + 1, sizeof(*where));
+	if (!slots || !where) {
+		free(slots);
+		free(where);
+		return -ENOMEM;
+	}
+
+	/* Put each variable where hsearch_r() would, in a new table */
+	for (p = env, n = 0; *p; p += strlen(p) + 1, n++) {
+		eq = strchr(p, '=');
+		*eq = '\0';
+		cur.hval = env_hash(p);
+		*eq = '=';
+		cur.n = n;
+
+		for (idx = (cur.hval & (nel - 1)) + 1, cur.used = 1;
+		     slots[idx].used; idx = idx == nel ? 1 : idx + 1,
+		     cur.used++) {
+			if (cur.n == n && slots[idx].hval == cur.hval &&
+			    same_name(p, env + where[slots[idx].n])) {
+				free(slots);
+				free(where);
+				return -EINVAL;
+			}
+			if (slots[idx].used < cur.used) {
+				tmp = slots[idx];
+				slots[idx] = cur;
+				cur = tmp;
+			}
+		}
+		slots[idx] = cur;
+		where[n] = p - env;
+	}
+
+	/* The entries go in the order of the variables */
+	for (idx = 1; idx <= nel; idx++) {
+		if (!slots[idx].used)
+			continue;
+		n = slots[idx].n;
+		p = env + where[n];
+		eq = strchr(p, '=');
+
+		ent.hval = cpu_to_le32(slots[idx].hval);
+		ent.slot = cpu_to_le32(idx);
+		ent.key = cpu_to_le32(p - env);
+		ent.value = eq + 1 - env;
+		if (strchr(eq, '\\'))
+			ent.value |= ENV_INDEX_ESCAPED;
+		ent.value = cpu_to_le32(ent.value);
+		memcpy(list + n * sizeof(ent), &ent, sizeof(ent));
+	}
+	free(slots);
+	free(where);
+
+	hdr.len = cpu_to_le32(len);
+	hdr.crc = cpu_to_le32(crc32(0, (unsigned char *)env, len));
+	hdr.size = cpu_to_le32(nel);
+	hdr.count = cpu_to_le32(count);
+	hdr.version = cpu_to_le32(ENV_INDEX_VERSION);
+	hdr.magic = cpu_to_le32(ENV_INDEX_MAGIC);
+	memcpy(list + count * sizeof(ent), &hdr, sizeof(hdr));
+
+	return 0;
+}
+
+const void *env_index_find(const char *env, size_t size,
+			   struct env_index_hdr *hdr)
+{
+	size_t room;
+
+	if (size < sizeof(*hdr))
+		return NULL;
+	memcpy(hdr, env + size - sizeof(*hdr), sizeof(*hdr));
+	hdr->magic = le32_to_cpu(hdr->magic);
+	hdr->version = le32_to_cpu(hdr->version);
+	if (hdr->magic != ENV_INDEX_MAGIC || hdr->version != ENV_INDEX_VERSION)
+		return NULL;
+	hdr->len = le32_to_cpu(hdr->len);
+	hdr->crc = le32_to_cpu(hdr->crc);
+	hdr->size = le32_to_cpu(hdr->size);
+	hdr->count = le32_to_cpu(hdr->count);
+
+	/* as hsearch_r() keeps it: a power of two, at most 3/4 full */
+	if (hdr->size < 8 || (hdr->size & (hdr->size - 1)) ||
+	    hdr->count > hdr->size / 4 * 3 ||
+	    hdr->count > size / sizeof(struct env_index_ent))
+		return NULL;
+	room = hdr->count * sizeof(struct env_index_ent) + sizeof(*hdr);
+	if (!hdr->len || room > size || hdr->len > size - room)
+		return NULL;
+
+	/* The variables must end with an empty string, and be the same ones */
+	if (env[hdr->len - 1] || (hdr->len > 1 && env[hdr->len - 2]))
+		return NULL;
+	if (crc32(0, (const unsigned char *)env, hdr->len) != hdr->crc)
+		return NULL;
+
+	return env + size - room;
+}
@@ -40,6 +40,7 @@ void hang(void)
 #if !defined(CONFIG_SPL_BUILD) || (defined(CONFIG_SPL_LIBCOMMON_SUPPORT) && \
 		defined(CONFIG_SPL_SERIAL_SUPPORT))
 	puts("### ERROR ### Please RESET the board ###\n");
+	serial_flush();
 #endif
 	bootstage_error(BOOTSTAGE_ID_NEED_RESET);
 	for (;;)
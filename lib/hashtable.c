@@ -56,6 +56,7 @@
 
 #include <env_callback.h>
 #include <env_flags.h>
+#include <env_index.h>
 #include <search.h>
 #include <slre.h>
 
@@ -70,8 +71,15 @@
  * which describes the current status.
  */
 
+/*
+ * used is 0 for a free slot, otherwise one more than how far the slot is
+ * from the entry's home slot, the one its hash points at. hval is the
+ * whole hash of the key: it is compared before the key itself, and the
+ * table can grow without hashing any key again.
+ */
 typedef struct _ENTRY {
 	int used;
+	unsigned int hval;
 	ENTRY entry;
 } _ENTRY;
 
@@ -80,38 +88,41 @@ static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 	int idx);
 
 /*
- * hcreate()
+ * Free an entry's key or data, unless it points into data imported with
+ * an index: such an entry only gets its own copy once it is changed.
  */
-
-/*
- * For the used double hash method the table size has to be a prime. To
- * correct the user given table size we need a prime test.  This trivial
- * algorithm is adequate because
- * a)  the code is (most probably) called a few times per program run and
- * b)  the number is small because the table must fit in the core
- * */
-static int isprime(unsigned int number)
+static void hfree(struct hsearch_data *htab, const char *p)
 {
-	/* no even number will be passed */
-	unsigned int div = 3;
-
-	while (div * div < number && number % div != 0)
-		div += 2;
+	if (htab->image && p >= htab->image &&
+	    p < htab->image + htab->image_len)
+		return;
+	free((void *)p);
+}
 
-	return number % div != 0;
+/* Drop the list of entries by key, once entries are added or moved */
+static void hunsort(struct hsearch_data *htab)
+{
+	free(htab->sorted);
+	htab->sorted = NULL;
 }
 
+/*
+ * hcreate()
+ */
+
 /*
  * Before using the hash table we must allocate memory for it.
- * Test for an existing table are done. We allocate one element
- * more as the found prime number says. This is done for more effective
- * indexing as explained in the comment for the hsearch function.
- * The contents of the table is zeroed, especially the field used
- * becomes zero.
+ * Test for an existing table are done. The size is rounded up to a power
+ * of two, so that the home slot of an entry is just the low bits of its
+ * hash. We allocate one element more, as index zero is never used (see
+ * the comment for the hsearch function). The contents of the table is
+ * zeroed, especially the field used becomes zero.
  */
 
 int hcreate_r(size_t nel, struct hsearch_data *htab)
 {
+	unsigned int size;
+
 	/* Test for correct arguments.  */
 	if (htab == NULL) {
 		__set_errno(EINVAL);
@@ -122,13 +133,12 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 	if (htab->table != NULL)
 		return 0;
 
-	/* Change nel to the first prime number not smaller as nel. */
-	nel |= 1;		/* make odd */
-	while (!isprime(nel))
-		nel += 2;
+	for (size = 8; size < nel; size <<= 1)
+		;
 
-	htab->size = nel;
+	htab->size = size;
 	htab->filled = 0;
+	htab->sorted = NULL;
 
 	/* allocate memory and zero out */
 	htab->table = (_ENTRY *) calloc(htab->size + 1, sizeof(_ENTRY));
@@ -164,11 +174,14 @@ void hdestroy_r(struct hsearch_data *htab)
 		if (htab->table[i].used > 0) {
 			ENTRY *ep = &htab->table[i].entry;
 
-			free((void *)ep->key);
-			free(ep->data);
+			hfree(htab, ep->key);
+			hfree(htab, ep->data);
 		}
 	}
 	free(htab->table);
+	free(htab->image);
+	htab->image = NULL;
+	hunsort(htab);
 
 	/* the sign for an existing table is an value != NULL in htable */
 	htab->table = NULL;
@@ -179,18 +192,23 @@ void hdestroy_r(struct hsearch_data *htab)
  */
 
 /*
- * This is the search function. It uses double hashing with open addressing.
- * The argument item.key has to be a pointer to an zero terminated, most
- * probably strings of chars. The function for generating a number of the
- * strings is simple but fast. It can be replaced by a more complex function
- * like ajw (see [Aho,Sethi,Ullman]) if the needs are shown.
+ * This is the search function. It uses open addressing with robin hood
+ * linear probing. The argument item.key has to be a pointer to an zero
+ * terminated, most probably strings of chars; env_hash() turns it into a
+ * 32 bit number whose low bits pick the home slot.
  *
- * We use an trick to speed up the lookup. The table is created by hcreate
- * with one more element available. This enables us to use the index zero
- * special. This index will never be used because we store the first hash
- * index in the field used where zero means not used. Every other value
- * means used. The used field can be used as a first fast comparison for
- * equality of the stored and the parameter value. This helps to prevent
+ * An entry goes in the first free slot from its home slot on, except
+ * that on the way it takes the place of any entry which is nearer to its
+ * own home slot than the new one would be; that entry moves on in its
+ * place. So no entry is ever much further from home than the others,
+ * and a search can stop as soon as it reaches an entry nearer to its
+ * home than the key being looked for would be. The table is grown when
+ * it is three quarters full, which keeps the runs short.
+ *
+ * The table is created by hcreate with one more element available. This
+ * enables us to use the index zero special: it is never used, so that a
+ * slot number can be returned as a positive value. The hash of each key
+ * is stored next to it and is compared first. This helps to prevent
  * unnecessary expensive calls of strcmp.
  *
  * This implementation differs from the standard library version of
@@ -208,28 +226,145 @@ void hdestroy_r(struct hsearch_data *htab)
  * - Instead of returning 1 on success, we return the index into the
  *   internal hash table, which is also guaranteed to be positive.
  *   This allows us direct access to the found hash table slot for
- *   example for functions like hdelete().
+ *   example for functions like hdelete(). Entries move when others are
+ *   added or deleted, so the index is only good until then.
+ */
+
+static inline unsigned int hhome(struct hsearch_data *htab, unsigned int hval)
+{
+	return (hval & (htab->size - 1)) + 1;
+}
+
+static inline unsigned int hnext(struct hsearch_data *htab, unsigned int idx)
+{
+	return idx == htab->size ? 1 : idx + 1;
+}
+
+/*
+ * Put an entry whose key is not in the table yet into a free slot, moving
+ * others on as needed. Returns the slot the new entry ends up in.
  */
+static unsigned int hplace(struct hsearch_data *htab, const _ENTRY *new)
+{
+	_ENTRY cur = *new, tmp;
+	unsigned int idx, ret = 0;
+
+	for (idx = hhome(htab, cur.hval), cur.used = 1; htab->table[idx].used;
+	     idx = hnext(htab, idx), cur.used++) {
+		if (htab->table[idx].used < cur.used) {
+			tmp = htab->table[idx];
+			htab->table[idx] = cur;
+			cur = tmp;
+			if (!ret)
+				ret = idx;
+		}
+	}
+	htab->table[idx] = cur;
+
+	return ret ? ret : idx;
+}
+
+/* Double the size of the table. Returns 1 if OK, 0 if out of memory */
+static int hgrow(struct hsearch_data *htab)
+{
+	_ENTRY *old = htab->table;
+	unsigned int i, size = htab->size;
+
+	debug("hgrow: %u entries, %u -> %u slots\n", htab->filled, size,
+	      size * 2);
+	htab->table = calloc(size * 2 + 1, sizeof(_ENTRY));
+	if (!htab->table) {
+		htab->table = old;
+		return 0;
+	}
+	htab->size = size * 2;
+
+	for (i = 1; i <= size; ++i) {
+		if (old[i].used > 0)
+			hplace(htab, &old[i]);
+	}
+	free(old);
+	hunsort(htab);
 
+	return 1;
+}
+
+#ifndef CONFIG_SPL_BUILD
+static int cmpkey(const void *p1, const void *p2)
+{
+	ENTRY *e1 = *(ENTRY **) p1;
+	ENTRY *e2 = *(ENTRY **) p2;
+
+	return (strcmp(e1->key, e2->key));
+}
+
+/*
+ * Make the list of entries sorted by key, if there isn't one already. It
+ * lasts until an entry is added or deleted. Returns 1 if OK, 0 if out of
+ * memory. An empty table has no list.
+ */
+static int hsort(struct hsearch_data *htab)
+{
+	unsigned int i, n;
+
+	if (htab->sorted || !htab->filled)
+		return 1;
+
+	htab->sorted = malloc(htab->filled * sizeof(ENTRY *));
+	if (!htab->sorted)
+		return 0;
+
+	for (i = 1, n = 0; i <= htab->size; ++i) {
+		if (htab->table[i].used > 0)
+			htab->sorted[n++] = &htab->table[i].entry;
+	}
+	qsort(htab->sorted, n, sizeof(ENTRY *), cmpkey);
+
+	return 1;
+}
+
+/*
+ * The names starting with match are together in the sorted list, so find
+ * the first by bisection and step through the rest. The value returned
+ * is one more than the position in the list, to be passed back as
+ * last_idx for the next match.
+ */
 int hmatch_r(const char *match, int last_idx, ENTRY ** retval,
 	     struct hsearch_data *htab)
 {
-	unsigned int idx;
+	unsigned int idx, lo, hi;
 	size_t key_len = strlen(match);
 
-	for (idx = last_idx + 1; idx < htab->size; ++idx) {
-		if (htab->table[idx].used <= 0)
-			continue;
-		if (!strncmp(match, htab->table[idx].entry.key, key_len)) {
-			*retval = &htab->table[idx].entry;
-			return idx;
+	if (!hsort(htab)) {
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+
+	if (last_idx > 0) {
+		idx = last_idx;
+	} else {
+		for (lo = 0, hi = htab->filled; lo < hi; ) {
+			idx = lo + (hi - lo) / 2;
+			if (strcmp(htab->sorted[idx]->key, match) < 0)
+				lo = idx + 1;
+			else
+				hi = idx;
 		}
+		idx = lo;
+	}
+
+	if (idx < htab->filled &&
+	    !strncmp(match, htab->sorted[idx]->key, key_len)) {
+		*retval = htab->sorted[idx];
+		return idx + 1;
 	}
 
 	__set_errno(ESRCH);
 	*retval = NULL;
 	return 0;
 }
+#endif
 
 /*
  * Compare an existing entry with the desired key, and overwrite if the action
@@ -239,7 +374,7 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 	ENTRY **retval, struct hsearch_data *htab, int flag,
 	unsigned int hval, unsigned int idx)
 {
-	if (htab->table[idx].used == hval
+	if (htab->table[idx].hval == hval
 	    && strcmp(item.key, htab->table[idx].entry.key) == 0) {
 		/* Overwrite existing value? */
 		if ((action == ENTER) && (item.data != NULL)) {
@@ -265,7 +400,7 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 				return 0;
 			}
 
-			free(htab->table[idx].entry.data);
+			hfree(htab, htab->table[idx].entry.data);
 			htab->table[idx].entry.data = strdup(item.data);
 			if (!htab->table[idx].entry.data) {
 				__set_errno(ENOMEM);
@@ -284,87 +419,29 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 	      struct hsearch_data *htab, int flag)
 {
+	_ENTRY new;
 	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
 	unsigned int idx;
-	unsigned int first_deleted = 0;
-	int ret;
-
-	/* Compute an value for the given string. Perhaps use a better method. */
-	hval = len;
-	count = len;
-	while (count-- > 0) {
-		hval <<= 4;
-		hval += item.key[count];
-	}
-
-	/*
-	 * First hash function:
-	 * simply take the modul but prevent zero.
-	 */
-	hval %= htab->size;
-	if (hval == 0)
-		++hval;
-
-	/* The first index tried. */
-	idx = hval;
-
-	if (htab->table[idx].used) {
-		/*
-		 * Further action might be required according to the
-		 * action value.
-		 */
-		unsigned hval2;
+	int dist, ret;
 
-		if (htab->table[idx].used == -1
-		    && !first_deleted)
-			first_deleted = idx;
+	/* env_index_build() relies on this hash, and on hplace() */
+	hval = env_hash(item.key);
 
+	/* There is always a free slot, so this ends */
+	for (idx = hhome(htab, hval), dist = 1; htab->table[idx].used >= dist;
+	     idx = hnext(htab, idx), dist++) {
 		ret = _compare_and_overwrite_entry(item, action, retval, htab,
 			flag, hval, idx);
 		if (ret != -1)
 			return ret;
-
-		/*
-		 * Second hash function:
-		 * as suggested in [Knuth]
-		 */
-		hval2 = 1 + hval % (htab->size - 2);
-
-		do {
-			/*
-			 * Because SIZE is prime this guarantees to
-			 * step through all available indices.
-			 */
-			if (idx <= hval2)
-				idx = htab->size + idx - hval2;
-			else
-				idx -= hval2;
-
-			/*
-			 * If we visited all entries leave the loop
-			 * unsuccessfully.
-			 */
-			if (idx == hval)
-				break;
-
-			/* If entry is found use it. */
-			ret = _compare_and_overwrite_entry(item, action, retval,
-				htab, flag, hval, idx);
-			if (ret != -1)
-				return ret;
-		}
-		while (htab->table[idx].used);
 	}
 
-	/* An empty bucket has been found. */
 	if (action == ENTER) {
 		/*
-		 * If table is full and another entry should be
-		 * entered return with error.
+		 * Keep a quarter of the slots free; if the table can't grow
+		 * and another entry should be entered return with error.
 		 */
-		if (htab->filled == htab->size) {
+		if ((htab->filled + 1) * 4 > htab->size * 3 && !hgrow(htab)) {
 			__set_errno(ENOMEM);
 			*retval = NULL;
 			return 0;
@@ -374,20 +451,21 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 		 * Create new entry;
 		 * create copies of item.key and item.data
 		 */
-		if (first_deleted)
-			idx = first_deleted;
-
-		htab->table[idx].used = hval;
-		htab->table[idx].entry.key = strdup(item.key);
-		htab->table[idx].entry.data = strdup(item.data);
-		if (!htab->table[idx].entry.key ||
-		    !htab->table[idx].entry.data) {
+		memset(&new, '\0', sizeof(new));
+		new.hval = hval;
+		new.entry.key = strdup(item.key);
+		new.entry.data = strdup(item.data);
+		if (!new.entry.key || !new.entry.data) {
+			free((void *)new.entry.key);
+			free(new.entry.data);
 			__set_errno(ENOMEM);
 			*retval = NULL;
 			return 0;
 		}
 
+		idx = hplace(htab, &new);
 		++htab->filled;
+		hunsort(htab);
 
 		/* This is a new entry, so look up a possible callback */
 		env_callback_init(&htab->table[idx].entry);
@@ -441,15 +519,26 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 	int idx)
 {
+	unsigned int next;
+
 	/* free used ENTRY */
 	debug("hdelete: DELETING key \"%s\"\n", key);
-	free((void *)ep->key);
-	free(ep->data);
-	ep->callback = NULL;
-	ep->flags = 0;
-	htab->table[idx].used = -1;
+	hfree(htab, ep->key);
+	hfree(htab, ep->data);
+
+	/*
+	 * Move back a slot the entries after it which are away from home,
+	 * so that no search stops early at the gap.
+	 */
+	for (next = hnext(htab, idx); htab->table[next].used > 1;
+	     idx = next, next = hnext(htab, idx)) {
+		htab->table[idx] = htab->table[next];
+		htab->table[idx].used--;
+	}
+	memset(&htab->table[idx], '\0', sizeof(_ENTRY));
 
 	--htab->filled;
+	hunsort(htab);
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
@@ -533,14 +622,6 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
  *		bytes in the string will be '\0'-padded.
  */
 
-static int cmpkey(const void *p1, const void *p2)
-{
-	ENTRY *e1 = *(ENTRY **) p1;
-	ENTRY *e2 = *(ENTRY **) p2;
-
-	return (strcmp(e1->key, e2->key));
-}
-
 static int match_string(int flag, const char *str, const char *pat, void *priv)
 {
 	switch (flag & H_MATCH_METHOD) {
@@ -605,6 +686,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		 int argc, char * const argv[])
 {
 	ENTRY *list[htab->size];
+	ENTRY **sorted;
 	char *res, *p;
 	size_t totlen;
 	int i, n;
@@ -619,13 +701,16 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		"size = %zu\n", htab, htab->size, htab->filled, size);
 	/*
 	 * Pass 1:
-	 * search used entries,
+	 * search used entries (in key order when the sorted list can be
+	 * had, so that they need no sorting here),
 	 * save addresses and compute total length
 	 */
+	sorted = hsort(htab) ? htab->sorted : NULL;
 	for (i = 1, n = 0, totlen = 0; i <= htab->size; ++i) {
 
-		if (htab->table[i].used > 0) {
-			ENTRY *ep = &htab->table[i].entry;
+		if (sorted ? i <= htab->filled : htab->table[i].used > 0) {
+			ENTRY *ep = sorted ? sorted[i - 1] :
+					     &htab->table[i].entry;
 			int found = match_entry(ep, flag, argc, argv);
 
 			if ((argc > 0) && (found == 0))
@@ -638,7 +723,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 
 			totlen += strlen(ep->key) + 2;
 
-			if (sep == '\0') {
+			if (sep == '\0' && !strchr(ep->data, '\\')) {
 				totlen += strlen(ep->data);
 			} else {	/* check if escapes are needed */
 				char *s = ep->data;
@@ -656,8 +741,8 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 	}
 
 #ifdef DEBUG
-	/* Pass 1a: print unsorted list */
-	printf("Unsorted: n=%d\n", n);
+	/* Pass 1a: print list */
+	printf("%s: n=%d\n", sorted ? "Sorted" : "Unsorted", n);
 	for (i = 0; i < n; ++i) {
 		printf("\t%3d: %p ==> %-10s => %s\n",
 		       i, list[i], list[i]->key, list[i]->data);
@@ -665,7 +750,8 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 #endif
 
 	/* Sort list by keys */
-	qsort(list, n, sizeof(ENTRY *), cmpkey);
+	if (!sorted)
+		qsort(list, n, sizeof(ENTRY *), cmpkey);
 
 	/* Check if the user supplied buffer size is sufficient */
 	if (size) {
@@ -752,6 +838,126 @@ static int drop_var_from_set(const char *name, int nvars, char * vars[])
 	return res;
 }
 
+#ifdef CONFIG_ENV_INDEX
+/*
+ * Import data which carries an index (see env_index.h). The variables are
+ * copied in one go and each entry goes straight into the slot the index
+ * gives, pointing into that copy: nothing is parsed, hashed or strdup()ed.
+ * Callbacks and flags are set up and applied as hsearch_r() would.
+ *
+ * Returns 1 if OK, 0 on error, or -1 if the index doesn't hold up, in
+ * which case the table has been destroyed and the data should be parsed.
+ */
+static int himport_index(struct hsearch_data *htab, const char *env,
+			 const struct env_index_hdr *hdr, const char *list,
+			 int flag)
+{
+	struct env_index_ent ent;
+	unsigned int i, slot, hval, key, value, escaped, rejected;
+	char *image, *dp, *sp;
+	ENTRY *ep;
+
+	if (htab->table)
+		hdestroy_r(htab);
+
+	image = malloc(hdr->len);
+	htab->table = calloc(hdr->size + 1, sizeof(_ENTRY));
+	if (!image || !htab->table) {
+		free(image);
+		free(htab->table);
+		htab->table = NULL;
+		__set_errno(ENOMEM);
+		return 0;
+	}
+	memcpy(image, env, hdr->len);
+	htab->size = hdr->size;
+	htab->filled = 0;
+	htab->image = image;
+	htab->image_len = hdr->len;
+
+	for (i = 0; i < hdr->count; i++) {
+		memcpy(&ent, list + i * sizeof(ent), sizeof(ent));
+		hval = le32_to_cpu(ent.hval);
+		slot = le32_to_cpu(ent.slot);
+		key = le32_to_cpu(ent.key);
+		value = le32_to_cpu(ent.value);
+		escaped = value & ENV_INDEX_ESCAPED;
+		value &= ~ENV_INDEX_ESCAPED;
+
+		if (!slot || slot > htab->size ||
+		    htab->table[slot].used || value < 2 || key >= value - 1 ||
+		    value >= hdr->len || (key && image[key - 1]) ||
+		    image[value - 1] != '=') {
+			debug("himport_r: bad index entry %u\n", i);
+			hdestroy_r(htab);
+			return -1;
+		}
+		image[value - 1] = '\0';
+
+		/* as himport_r() unescapes each value */
+		if (escaped) {
+			for (dp = sp = image + value; *dp; ++dp) {
+				if ((*dp == '\\') && *(dp + 1))
+					++dp;
+				*sp++ = *dp;
+			}
+			*sp = '\0';
+		}
+
+		htab->table[slot].used = ((slot - hhome(htab, hval)) &
+					  (htab->size - 1)) + 1;
+		htab->table[slot].hval = hval;
+		htab->table[slot].entry.key = image + key;
+		htab->table[slot].entry.data = image + value;
+		++htab->filled;
+	}
+
+	/*
+	 * Now that all are in, apply them in the order they were exported.
+	 * Deleting an entry moves others, so until the index is done with
+	 * those rejected are only marked, by dropping the value.
+	 */
+	for (i = 0, rejected = 0; i < hdr->count; i++) {
+		memcpy(&ent, list + i * sizeof(ent), sizeof(ent));
+		slot = le32_to_cpu(ent.slot);
+		ep = &htab->table[slot].entry;
+
+		env_callback_init(ep);
+		env_flags_init(ep);
+
+		if (htab->change_ok != NULL && htab->change_ok(ep, ep->data,
+		    env_op_create, flag)) {
+			debug("change_ok() rejected setting variable "
+				"%s, skipping it!\n", ep->key);
+			ep->data = NULL;
+			rejected++;
+			continue;
+		}
+
+		if (ep->callback && ep->callback(ep->key, ep->data,
+		    env_op_create, flag)) {
+			debug("callback() rejected setting variable "
+				"%s, skipping it!\n", ep->key);
+			ep->data = NULL;
+			rejected++;
+		}
+	}
+
+	/* A slot gets the entry after it when that is deleted: look again */
+	for (i = 1; rejected && i <= htab->size; ) {
+		ep = &htab->table[i].entry;
+		if (htab->table[i].used > 0 && !ep->data) {
+			_hdelete(ep->key, htab, ep, i);
+			rejected--;
+		} else {
+			i++;
+		}
+	}
+
+	return 1;
+}
+#endif
+
 /*
  * Import linearized data into hash table.
  *
@@ -801,6 +1007,21 @@ int himport_r(struct hsearch_data *htab,
 		return 0;
 	}
 
+#ifdef CONFIG_ENV_INDEX
+	/* A whole stored environment may come with its table laid out */
+	if (sep == '\0' && !(flag & H_NOCLEAR) && !nvars) {
+		struct env_index_hdr hdr;
+		const char *list = env_index_find(env, size, &hdr);
+
+		if (list) {
+			int ret = himport_index(htab, env, &hdr, list, flag);
+
+			if (ret >= 0)
+				return ret;
+		}
+	}
+#endif
+
 	/* we allocate new space to make sure we can write to the array */
 	if ((data = malloc(size)) == NULL) {
 		debug("himport_r: can't malloc %zu bytes\n", size);
@@ -837,7 +1058,8 @@ int himport_r(struct hsearch_data *htab,
 	 * envrionment size), so we clip it to a reasonable value.
 	 * On the other hand we need to add some more entries for free
 	 * space when importing very small buffers. Both boundaries can
-	 * be overwritten in the board config file if needed.
+	 * be overwritten in the board config file if needed. The table
+	 * grows when it fills up, so this is only where it starts.
 	 */
 
 	if (!htab->table) {
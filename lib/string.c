@@ -19,6 +19,7 @@
 #include <linux/string.h>
 #include <linux/ctype.h>
 #include <malloc.h>
+#include <asm/byteorder.h>
 
 
 /**
@@ -461,6 +462,13 @@ char * bcopy(const char * src, char * dest, int count)
 #endif
 
 #ifndef __HAVE_ARCH_MEMCPY
+/* Join the end of w0 and the start of w1 into one word, for memcpy() */
+#ifdef __LITTLE_ENDIAN
+#define MEMCPY_MERGE(w0, sh0, w1, sh1)	(((w0) >> (sh0)) | ((w1) << (sh1)))
+#else
+#define MEMCPY_MERGE(w0, sh0, w1, sh1)	(((w0) << (sh0)) | ((w1) >> (sh1)))
+#endif
+
 /**
  * memcpy - Copy one area of memory to another
  * @dest: Where to copy to
@@ -473,13 +481,47 @@ char * bcopy(const char * src, char * dest, int count)
 void * memcpy(void *dest, const void *src, size_t count)
 {
 	unsigned long *dl = (unsigned long *)dest, *sl = (unsigned long *)src;
+	unsigned long w0, w1;
+	unsigned int off, sh0, sh1;
 	char *d8, *s8;
 
 	if (src == dest)
 		return dest;
 
+	/*
+	 * Misaligned but long enough to be worth it: align the destination,
+	 * then build each word from the two aligned source words it spans.
+	 * Only words holding bytes that are copied are read.
+	 */
+	if ((((ulong)dest | (ulong)src) & (sizeof(*dl) - 1)) &&
+	    count >= 4 * sizeof(*dl)) {
+		d8 = (char *)dest;
+		s8 = (char *)src;
+		while ((ulong)d8 & (sizeof(*dl) - 1)) {
+			*d8++ = *s8++;
+			count--;
+		}
+		dl = (unsigned long *)d8;
+		off = (ulong)s8 & (sizeof(*dl) - 1);
+		if (off) {
+			sl = (unsigned long *)(s8 - off);
+			sh0 = off * 8;
+			sh1 = sizeof(*dl) * 8 - sh0;
+			w0 = *sl++;
+			while (count >= sizeof(*dl)) {
+				w1 = *sl++;
+				*dl++ = MEMCPY_MERGE(w0, sh0, w1, sh1);
+				w0 = w1;
+				count -= sizeof(*dl);
+			}
+			sl = (unsigned long *)((char *)sl - sizeof(*dl) + off);
+		} else {
+			sl = (unsigned long *)s8;
+		}
+	}
+
 	/* while all data is aligned (common case), copy a word at a time */
-	if ( (((ulong)dest | (ulong)src) & (sizeof(*dl) - 1)) == 0) {
+	if ( (((ulong)dl | (ulong)sl) & (sizeof(*dl) - 1)) == 0) {
 		while (count >= sizeof(*dl)) {
 			*dl++ = *sl++;
 			count -= sizeof(*dl);
@@ -47,3 +47,20 @@ void mdelay(unsigned long msec)
 	while (msec--)
 		udelay(1000);
 }
+
+/* Without a finer timebase, round up to the next microsecond */
+static void __def_ndelay(unsigned long nsec)
+{
+	__udelay(DIV_ROUND_UP(nsec, 1000));
+}
+void __ndelay(unsigned long nsec)
+	__attribute__((weak, alias("__def_ndelay")));
+
+void ndelay(unsigned long nsec)
+{
+	/* long delays go through udelay() so the watchdog is kept alive */
+	if (nsec >= 1000000)
+		udelay(DIV_ROUND_UP(nsec, 1000));
+	else
+		__ndelay(nsec);
+}
@@ -24,6 +24,10 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#ifndef CONFIG_TRACE_CALL_DEPTH_LIMIT
+#define CONFIG_TRACE_CALL_DEPTH_LIMIT	15
+#endif
+
 static char trace_enabled __attribute__((section(".data")));
 static char trace_inited __attribute__((section(".data")));
 
@@ -337,7 +341,7 @@ int __attribute__((no_instrument_function)) trace_init(void *buff,
 	add_textbase();
 
 	puts("trace: enabled\n");
-	hdr->depth_limit = 15;
+	hdr->depth_limit = CONFIG_TRACE_CALL_DEPTH_LIMIT;
 	trace_enabled = 1;
 	trace_inited = 1;
 	return 0;
@@ -23,6 +23,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <lazy_init.h>
 #include <net.h>
 #include <miiphy.h>
 #include <phy.h>
@@ -130,6 +131,7 @@ struct eth_device *eth_get_dev_by_name(const char *devname)
 
 	BUG_ON(devname == NULL);
 
+	lazy_init("eth");
 	if (!eth_devices)
 		return NULL;
 
@@ -150,6 +152,7 @@ struct eth_device *eth_get_dev_by_index(int index)
 {
 	struct eth_device *dev, *target_dev;
 
+	lazy_init("eth");
 	if (!eth_devices)
 		return NULL;
 
@@ -405,6 +408,7 @@ int eth_init(bd_t *bis)
 {
 	struct eth_device *old_current, *dev;
 
+	lazy_init("eth");
 	if (!eth_current) {
 		puts("No ethernet found.\n");
 		return -1;
@@ -543,6 +547,7 @@ void eth_set_current(void)
 	struct eth_device *old_current;
 	int	env_id;
 
+	lazy_init("eth");
 	if (!eth_current)	/* XXX no current */
 		return;
 
@@ -0,0 +1,98 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#define DEBUG
+
+#include <common.h>
+#include <command.h>
+#include <env_index.h>
+#include <errno.h>
+#include <search.h>
+
+static const char ut_env[] = "ut_one=1\0ut_two=2\0ut_esc=a\\\\b\0\0";
+
+static const char *ut_find(struct hsearch_data *htab, const char *name)
+{
+	ENTRY e, *ep;
+
+	e.key = name;
+	e.data = NULL;
+	hsearch_r(e, FIND, &ep, htab, 0);
+
+	return ep ? ep->data : NULL;
+}
+
+static int do_ut_env_index(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+	struct hsearch_data htab;
+	struct env_index_hdr hdr;
+	char buf[256];
+	ENTRY e, *ep;
+
+	printf("%s: Testing the environment index\n", __func__);
+
+	memset(buf, '\0', sizeof(buf));
+	memcpy(buf, ut_env, sizeof(ut_env));
+	assert(!env_index_build(buf, sizeof(buf), 7));
+	assert(env_index_build(buf, sizeof(ut_env) + 8, 7) == -ENOSPC);
+
+	/* entries point into the imported copy */
+	memset(&htab, '\0', sizeof(htab));
+	assert(himport_r(&htab, buf, sizeof(buf), '\0', 0, 0, NULL));
+	assert(htab.image && htab.size == 8 && htab.filled == 3);
+	assert(!strcmp(ut_find(&htab, "ut_one"), "1"));
+	assert(!strcmp(ut_find(&htab, "ut_esc"), "a\\b"));
+	assert(!ut_find(&htab, "ut_three"));
+
+	/* changes get their own copies */
+	e.key = "ut_two";
+	e.data = "22";
+	assert(hsearch_r(e, ENTER, &ep, &htab, 0));
+	assert(ep->data < htab.image ||
+	       ep->data >= htab.image + htab.image_len);
+	assert(!strcmp(ut_find(&htab, "ut_two"), "22"));
+	assert(hdelete_r("ut_one", &htab, 0));
+	assert(!ut_find(&htab, "ut_one"));
+	hdestroy_r(&htab);
+	assert(!htab.image);
+
+	/* an index left behind by a change to the variables is ignored */
+	assert(env_index_find(buf, sizeof(buf), &hdr));
+	buf[strlen("ut_one=1") + 1 + strlen("ut_two=")] = '3';
+	assert(!env_index_find(buf, sizeof(buf), &hdr));
+	assert(himport_r(&htab, buf, sizeof(buf), '\0', 0, 0, NULL));
+	assert(!htab.image && !strcmp(ut_find(&htab, "ut_two"), "3"));
+	hdestroy_r(&htab);
+	buf[strlen("ut_one=1") + 1 + strlen("ut_two=")] = '2';
+
+	/* a bad index is ignored and the variables parsed */
+	buf[sizeof(buf) - 1] ^= 0xff;
+	assert(himport_r(&htab, buf, sizeof(buf), '\0', 0, 0, NULL));
+	assert(!htab.image && htab.filled == 3);
+	assert(!strcmp(ut_find(&htab, "ut_two"), "2"));
+	hdestroy_r(&htab);
+
+	printf("%s: Everything went swimmingly\n", __func__);
+	return 0;
+}
+
+U_BOOT_CMD(
+	ut_env_index,	1,	1,	do_ut_env_index,
+	"Very basic test of the environment index",
+	""
+);
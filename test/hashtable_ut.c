@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#define DEBUG
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <env_callback.h>
+#include <env_flags.h>
+#include <malloc.h>
+#include <search.h>
+
+/* Size env_relocate() starts the table at, with the default settings */
+#define UT_HTAB_NEL	512
+#define UT_HTAB_ROUNDS	20
+
+/*
+ * The table as it was before robin hood probing, fixed size with double
+ * hashing over a prime, kept here to compare against. Only what the
+ * benchmark needs: entering new variables and finding them.
+ */
+struct old_entry {
+	unsigned int used;
+	ENTRY entry;
+};
+
+struct old_htab {
+	struct old_entry *table;
+	unsigned int size;
+	unsigned int filled;
+};
+
+static int old_isprime(unsigned int number)
+{
+	unsigned int div = 3;
+
+	while (div * div < number && number % div != 0)
+		div += 2;
+
+	return number % div != 0;
+}
+
+static int old_create(struct old_htab *htab, unsigned int nel)
+{
+	nel |= 1;
+	while (!old_isprime(nel))
+		nel += 2;
+	htab->size = nel;
+	htab->filled = 0;
+	htab->table = calloc(nel + 1, sizeof(struct old_entry));
+
+	return htab->table != NULL;
+}
+
+static void old_destroy(struct old_htab *htab)
+{
+	unsigned int i;
+
+	for (i = 1; i <= htab->size; i++) {
+		if (htab->table[i].used) {
+			free((void *)htab->table[i].entry.key);
+			free(htab->table[i].entry.data);
+		}
+	}
+	free(htab->table);
+}
+
+/*
+ * As hsearch_r() was, less the permission checks and callbacks. Kept out
+ * of line, and not cloned for the calls below, so that calling it costs
+ * the same as calling the real one in lib/hashtable.c.
+ */
+static int __attribute__((__noinline__, __noclone__))
+old_hsearch(ENTRY item, ACTION action, ENTRY **retval, struct old_htab *htab)
+{
+	unsigned int len = strlen(item.key);
+	unsigned int hval = len, hval2, idx;
+
+	while (len-- > 0) {
+		hval <<= 4;
+		hval += (unsigned char)item.key[len];
+	}
+	hval %= htab->size;
+	if (!hval)
+		hval = 1;
+
+	idx = hval;
+	if (htab->table[idx].used) {
+		if (htab->table[idx].used == hval &&
+		    !strcmp(item.key, htab->table[idx].entry.key))
+			goto found;
+
+		hval2 = 1 + hval % (htab->size - 2);
+		do {
+			if (idx <= hval2)
+				idx = htab->size + idx - hval2;
+			else
+				idx -= hval2;
+			if (idx == hval)
+				break;
+			if (htab->table[idx].used == hval &&
+			    !strcmp(item.key, htab->table[idx].entry.key))
+				goto found;
+		} while (htab->table[idx].used);
+	}
+
+	if (action == FIND || htab->filled == htab->size) {
+		__set_errno(action == FIND ? ESRCH : ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+
+	htab->table[idx].used = hval;
+	htab->table[idx].entry.key = strdup(item.key);
+	htab->table[idx].entry.data = strdup(item.data);
+	htab->filled++;
+	env_callback_init(&htab->table[idx].entry);
+	env_flags_init(&htab->table[idx].entry);
+found:
+	*retval = &htab->table[idx].entry;
+	return idx;
+}
+
+/* Names like those of a scripted boot menu */
+static void ut_name(char *name, int i)
+{
+	sprintf(name, "menu_%d_%s%d", i / 8, i % 8 ? "cmd" : "title", i % 8);
+}
+
+static void ut_htab_bench(int count)
+{
+	struct hsearch_data htab;
+	struct old_htab old;
+	ulong start, new_enter, new_find, old_enter, old_find;
+	char (*names)[32];
+	ENTRY e, *ep;
+	int i, round;
+
+	/* the names of count variables, then of as many unknown ones */
+	names = malloc(count * 2 * sizeof(*names));
+	assert(names);
+	for (i = 0; i < count * 2; i++)
+		ut_name(names[i], i);
+
+	memset(&htab, '\0', sizeof(htab));
+	assert(hcreate_r(UT_HTAB_NEL, &htab));
+	start = timer_get_us();
+	for (i = 0; i < count; i++) {
+		e.key = names[i];
+		e.data = "1";
+		assert(hsearch_r(e, ENTER, &ep, &htab, 0));
+	}
+	new_enter = timer_get_us() - start;
+
+	start = timer_get_us();
+	for (round = 0; round < UT_HTAB_ROUNDS; round++) {
+		for (i = 0; i < count * 2; i++) {
+			e.key = names[i];
+			e.data = NULL;
+			hsearch_r(e, FIND, &ep, &htab, 0);
+			assert(!ep == (i >= count));
+		}
+	}
+	new_find = timer_get_us() - start;
+
+	printf("%5d %5u %8lu %8lu", count, htab.size, new_enter, new_find);
+	hdestroy_r(&htab);
+
+	assert(old_create(&old, UT_HTAB_NEL));
+	if (count > old.size) {
+		printf("   full at %u\n", old.size);
+		goto out;
+	}
+	start = timer_get_us();
+	for (i = 0; i < count; i++) {
+		e.key = names[i];
+		e.data = "1";
+		assert(old_hsearch(e, ENTER, &ep, &old));
+	}
+	old_enter = timer_get_us() - start;
+
+	start = timer_get_us();
+	for (round = 0; round < UT_HTAB_ROUNDS; round++) {
+		for (i = 0; i < count * 2; i++) {
+			e.key = names[i];
+			e.data = NULL;
+			old_hsearch(e, FIND, &ep, &old);
+			assert(!ep == (i >= count));
+		}
+	}
+	old_find = timer_get_us() - start;
+
+	printf("   %5u %8lu %8lu\n", old.size, old_enter, old_find);
+out:
+	old_destroy(&old);
+	free(names);
+}
+
+static int do_ut_hashtable(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+	static const int counts[] = { 64, 256, 400, 500, 2000 };
+	struct hsearch_data htab;
+	char name[32];
+	ENTRY e, *ep;
+	int i, idx;
+
+	printf("%s: Testing the hash table\n", __func__);
+
+	/* grows past the size it was made with */
+	memset(&htab, '\0', sizeof(htab));
+	assert(hcreate_r(5, &htab));
+	assert(htab.size == 8);
+	for (i = 0; i < 100; i++) {
+		ut_name(name, i);
+		e.key = name;
+		e.data = name;
+		assert(hsearch_r(e, ENTER, &ep, &htab, 0));
+	}
+	assert(htab.filled == 100 && htab.size == 256);
+
+	/* deleting moves entries back, which must still be found */
+	for (i = 0; i < 100; i += 2) {
+		ut_name(name, i);
+		assert(hdelete_r(name, &htab, 0));
+	}
+	for (i = 0; i < 100; i++) {
+		ut_name(name, i);
+		e.key = name;
+		e.data = NULL;
+		hsearch_r(e, FIND, &ep, &htab, 0);
+		assert(i % 2 ? ep && !strcmp(ep->data, name) : !ep);
+	}
+
+	/* prefix matches come in order */
+	idx = 0;
+	name[0] = '\0';
+	for (i = 0; (idx = hmatch_r("menu_2", idx, &ep, &htab)); i++) {
+		assert(!strncmp(ep->key, "menu_2_cmd", 10));
+		assert(strcmp(name, ep->key) < 0);
+		strcpy(name, ep->key);
+	}
+	assert(i == 4);
+	assert(!hmatch_r("menu_99", 0, &ep, &htab) && !ep);
+	hdestroy_r(&htab);
+
+	/*
+	 * Microseconds to enter the variables, then to look each up and as
+	 * many unknown names, UT_HTAB_ROUNDS times
+	 */
+	puts(" vars slots    enter     find   was: slots    enter     find\n");
+	for (i = 0; i < ARRAY_SIZE(counts); i++)
+		ut_htab_bench(counts[i]);
+
+	printf("%s: Everything went swimmingly\n", __func__);
+	return 0;
+}
+
+U_BOOT_CMD(
+	ut_hashtable,	1,	1,	do_ut_hashtable,
+	"Test the hash table and compare it with the old one",
+	""
+);
@@ -0,0 +1,72 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#define DEBUG
+
+#include <common.h>
+#include <errno.h>
+#include <profile.h>
+
+/* Keep the CPU busy for ms milliseconds, almost all of it in here */
+static noinline void profile_ut_spin(ulong ms)
+{
+	volatile ulong sum = 0;
+	ulong start = get_timer(0);
+	int i;
+
+	while (get_timer(start) < ms) {
+		for (i = 0; i < 100000; i++)
+			sum += i;
+	}
+}
+
+static int do_ut_profile(cmd_tbl_t *cmdtp, int flag, int argc,
+			 char * const argv[])
+{
+	ulong spin = (ulong)profile_ut_spin;
+	ulong samples;
+
+	printf("%s: Testing the sampling profiler\n", __func__);
+
+	profile_clear();
+	assert(!profile_start(1000));
+	assert(profile_start(1000) == -EBUSY);
+	profile_ut_spin(500);
+	profile_stop();
+
+	/* most samples land in the loop above */
+	samples = profile_count(0, ~0UL);
+	assert(samples > 0);
+	assert(profile_count(spin, spin + 0x100) * 2 > samples);
+
+	/* nothing more is recorded once stopped */
+	profile_ut_spin(100);
+	assert(profile_count(0, ~0UL) == samples);
+
+	profile_report(5);
+	profile_clear();
+	assert(profile_count(0, ~0UL) == 0);
+
+	printf("%s: Everything went swimmingly\n", __func__);
+	return 0;
+}
+
+U_BOOT_CMD(
+	ut_profile,	1,	1,	do_ut_profile,
+	"Very basic test of the sampling profiler",
+	""
+);
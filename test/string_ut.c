@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * memcpy/memmove/memset checks against byte-at-a-time references, over
+ * every source and destination alignment, plus a rough throughput figure.
+ * The same cases run in sandbox (lib/string.c) and on boards that use the
+ * assembler versions (CONFIG_USE_ARCH_MEMCPY/MEMSET).
+ */
+
+#include <common.h>
+#include <malloc.h>
+
+#define MAX_ALIGN	8
+#define MAX_LEN		300
+#define GUARD		16
+#define BUF_SIZE	(MAX_ALIGN + MAX_LEN + 2 * GUARD)
+
+#define SPEED_LEN	(64 << 10)
+#define SPEED_LOOPS	64
+
+static u8 src[BUF_SIZE] __aligned(MAX_ALIGN);
+static u8 dst[BUF_SIZE] __aligned(MAX_ALIGN);
+static u8 ref[BUF_SIZE] __aligned(MAX_ALIGN);
+
+static void fill(u8 *buf, u8 seed)
+{
+	int i;
+
+	for (i = 0; i < BUF_SIZE; i++)
+		buf[i] = seed + i * 7;
+}
+
+static int check(const char *name, int doff, int soff, int len)
+{
+	if (!memcmp(dst, ref, BUF_SIZE))
+		return 0;
+
+	printf("%s: mismatch, dst+%d src+%d len %d\n", name, doff, soff, len);
+	return 1;
+}
+
+static int test_memcpy(void)
+{
+	int soff, doff, len, i;
+
+	fill(src, 0x11);
+	for (soff = 0; soff < MAX_ALIGN; soff++)
+		for (doff = 0; doff < MAX_ALIGN; doff++)
+			for (len = 0; len <= MAX_LEN; len++) {
+				memset(dst, 0xa5, BUF_SIZE);
+				memset(ref, 0xa5, BUF_SIZE);
+				memcpy(dst + GUARD + doff, src + GUARD + soff,
+				       len);
+				for (i = 0; i < len; i++)
+					ref[GUARD + doff + i] =
+						src[GUARD + soff + i];
+				if (check("memcpy", doff, soff, len))
+					return 1;
+			}
+
+	return 0;
+}
+
+/* Overlapping moves in both directions within one buffer */
+static int test_memmove(void)
+{
+	int soff, doff, len, i;
+
+	for (soff = 0; soff < 2 * MAX_ALIGN; soff++)
+		for (doff = 0; doff < 2 * MAX_ALIGN; doff++)
+			for (len = 0; len <= MAX_LEN - 2 * MAX_ALIGN; len++) {
+				fill(dst, 0x33);
+				fill(ref, 0x33);
+				memmove(dst + GUARD + doff, dst + GUARD + soff,
+					len);
+				memcpy(src, ref, BUF_SIZE);
+				for (i = 0; i < len; i++)
+					ref[GUARD + doff + i] =
+						src[GUARD + soff + i];
+				if (check("memmove", doff, soff, len))
+					return 1;
+			}
+
+	return 0;
+}
+
+static int test_memset(void)
+{
+	int doff, len, i;
+
+	for (doff = 0; doff < MAX_ALIGN; doff++)
+		for (len = 0; len <= MAX_LEN; len++) {
+			memset(dst, 0xa5, BUF_SIZE);
+			memset(ref, 0xa5, BUF_SIZE);
+			memset(dst + GUARD + doff, 0x5a, len);
+			for (i = 0; i < len; i++)
+				ref[GUARD + doff + i] = 0x5a;
+			if (check("memset", doff, 0, len))
+				return 1;
+		}
+
+	return 0;
+}
+
+/* Print MB/s for one copy or fill pattern */
+static void speed(const char *name, u8 *to, const u8 *from)
+{
+	ulong start, us;
+	int i;
+
+	start = timer_get_us();
+	for (i = 0; i < SPEED_LOOPS; i++) {
+		if (from)
+			memcpy(to, from, SPEED_LEN);
+		else
+			memset(to, i, SPEED_LEN);
+	}
+	us = timer_get_us() - start;
+	printf("   %-22s %6lu MB/s\n", name,
+	       us ? (ulong)SPEED_LEN * SPEED_LOOPS / us : 0);
+}
+
+static int do_ut_string(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	u8 *a, *b;
+
+	printf("%s: Testing memcpy/memmove/memset\n", __func__);
+	if (test_memcpy() || test_memmove() || test_memset())
+		return CMD_RET_FAILURE;
+
+	a = malloc(SPEED_LEN + MAX_ALIGN);
+	b = malloc(SPEED_LEN + MAX_ALIGN);
+	if (a && b) {
+		memset(a, 0, SPEED_LEN + MAX_ALIGN);
+		speed("memcpy aligned", b, a);
+		speed("memcpy dst+1", b + 1, a);
+		speed("memcpy src+2", b, a + 2);
+		speed("memcpy dst+2 src+6", b + 2, a + 6);
+		speed("memset", b, NULL);
+		speed("memset dst+3", b + 3, NULL);
+	}
+	free(a);
+	free(b);
+
+	printf("%s: Everything went swimmingly\n", __func__);
+	return 0;
+}
+
+U_BOOT_CMD(
+	ut_string,	1,	1,	do_ut_string,
+	"Check memcpy/memmove/memset against reference copies",
+	""
+);
@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+#define DEBUG
+
+#include <common.h>
+#include <timebase.h>
+
+static int do_ut_time(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	ulong start;
+	int i;
+
+	printf("%s: Testing timebase arithmetic\n", __func__);
+
+	/* conversions round up and never lose a partial tick */
+	assert(timebase_from_usec(0, 1000000) == 0);
+	assert(timebase_from_usec(1, 1000000) == 1);
+	assert(timebase_from_usec(1, 24000000) == 24);
+	assert(timebase_from_usec(1, 32768) == 1);
+	assert(timebase_from_usec(1000000, 32768) == 32768);
+	assert(timebase_from_usec(1001, 1000) == 2);
+	assert(timebase_from_usec(4000000000UL, 1000000) == 4000000000ULL);
+	assert(timebase_from_nsec(1, 1000000) == 1);
+	assert(timebase_from_nsec(1000, 1000000) == 1);
+	assert(timebase_from_nsec(1001, 1000000) == 2);
+	assert(timebase_from_nsec(100, 24000000) == 3);
+
+	/* a 2^32 period down counter needs no wrap correction */
+	assert(timebase_down_elapsed(100, 40) == 60);
+	assert(timebase_down_elapsed(100, 100) == 0);
+	assert(timebase_down_elapsed(5, 0xfffffffe) == 7);
+	assert(timebase_down_elapsed(0, 0xffffffff) == 1);
+
+	/* delays must never be short */
+	start = timer_get_us();
+	udelay(20000);
+	assert(timer_get_us() - start >= 20000);
+	start = timer_get_us();
+	ndelay(2000000);
+	assert(timer_get_us() - start >= 2000);
+
+	/*
+	 * With a timebase no finer than a microsecond, as on the Aspeed
+	 * boards, ndelay() rounds up to a whole one
+	 */
+	if (get_tbclk() <= 1000000) {
+		start = timer_get_us();
+		for (i = 0; i < 1000; i++)
+			ndelay(100);
+		assert(timer_get_us() - start >= 1000);
+	}
+
+	printf("%s: Everything went swimmingly\n", __func__);
+	return 0;
+}
+
+U_BOOT_CMD(
+	ut_time,	1,	1,	do_ut_time,
+	"Very basic test of timebase and delay functions",
+	""
+);
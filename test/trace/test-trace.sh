@@ -50,10 +50,40 @@ run_trace() {
 	hash sha256 0 10000
 	trace pause
 	trace stats
+	trace calls 2000000 2000000
+	sb save host 0 ${calls} \${profbase} \${profoffset}
 	reset
 END
 }
 
+# Turn the call list into each kind of report, and check that they all
+# show the hashing done above
+check_proftool() {
+	echo "Check proftool"
+	PROFTOOL="./${OUTPUT_DIR}/tools/proftool -m ${OUTPUT_DIR}/System.map"
+	PROFTOOL="${PROFTOOL} -p ${calls}"
+
+	${PROFTOOL} dump-ftrace >${tmp} || fail "proftool dump-ftrace"
+	if ! grep -q "sha256_update <- " ${tmp}; then
+		fail "ftrace output error"
+	fi
+
+	# Each line is a call stack and the microseconds spent at its top
+	${PROFTOOL} dump-flamegraph >${tmp} || fail "proftool dump-flamegraph"
+	if grep -qv "^[^ ;]\+\(;[^ ;]\+\)* [0-9]\+$" ${tmp}; then
+		fail "flame graph format error"
+	fi
+	if ! grep -q ";do_hash;.*sha256_update[; ]" ${tmp}; then
+		fail "flame graph output error"
+	fi
+
+	${PROFTOOL} dump-chrome >${tmp} || fail "proftool dump-chrome"
+	if [ $(grep -c '"name":"sha256_update","ph":"B"' ${tmp}) -ne \
+	     $(grep -c '"name":"sha256_update","ph":"E"' ${tmp}) ]; then
+		fail "chrome output error"
+	fi
+}
+
 check_results() {
 	echo "Check results"
 
@@ -82,8 +112,10 @@ check_results() {
 echo "Simple trace test / sanity check using sandbox"
 echo
 tmp="$(tempfile)"
+calls="$(tempfile)"
 build_uboot
 run_trace >${tmp}
 check_results ${tmp}
-rm ${tmp}
+check_proftool
+rm ${tmp} ${calls}
 echo "Test passed"
@@ -282,6 +282,18 @@ int fw_printenv (int argc, char *argv[])
 
 int fw_env_close(void)
 {
+	char *env, *end = &environment.data[ENV_SIZE];
+
+	/*
+	 * Clear what follows the variables. saveenv may have put an index
+	 * of them there (see include/env_index.h), which no longer fits.
+	 */
+	for (env = environment.data; env + 1 < end && (*env || *(env + 1));
+	     ++env)
+		;
+	if (env + 2 < end)
+		memset(env + 2, 0, end - (env + 2));
+
 	/*
 	 * Update CRC
 	 */
@@ -798,6 +810,14 @@ static int flash_write_buf (int dev, int fd, void *buf, size_t count,
 #endif
 		/* Overwrite the old environment */
 		memcpy (data + block_seek, buf, count);
+#ifdef CONFIG_ENV_LOG
+		/*
+		 * The rest of the sector is U-Boot's log of changes to the
+		 * environment, which this one already holds: leave it empty
+		 */
+		memset (data + block_seek + count, 0xff,
+			write_total - block_seek - count);
+#endif
 	} else {
 		/*
 		 * We get here, iff offset is block-aligned and count is a
@@ -1064,6 +1084,92 @@ static char *envmatch (char * s1, char * s2)
 	return NULL;
 }
 
+#ifdef CONFIG_ENV_LOG
+/*
+ * U-Boot's saveenv appends the variables changed or deleted to a log in
+ * the rest of the sector, see common/env_flash.c. Apply the records which
+ * belong to the environment just read, as U-Boot does when it starts.
+ */
+struct env_log_rec {
+	uint32_t crc;		/* CRC32 over the rest of the record */
+	uint32_t base_crc;	/* CRC of the environment it applies to */
+	uint32_t len;		/* bytes of data */
+};
+
+static int env_log_replay (void)
+{
+	struct env_log_rec rec;
+	char *log, *p, *end, *next, *value;
+	size_t size, off;
+	uint32_t crc;
+	int fd, rc;
+
+	/* Nothing applies to the default environment */
+	if (crc32 (0, (uint8_t *) environment.data, ENV_SIZE) !=
+	    *environment.crc)
+		return 0;
+
+	size = DEVESIZE (dev_current) -
+		DEVOFFSET (dev_current) % DEVESIZE (dev_current);
+	if (size <= CUR_ENVSIZE + sizeof (rec))
+		return 0;
+	size -= CUR_ENVSIZE;
+
+	log = malloc (size);
+	if (log == NULL) {
+		fprintf (stderr,
+			"Not enough memory for environment log (%zu bytes)\n",
+			size);
+		return -1;
+	}
+
+	fd = open (DEVNAME (dev_current), O_RDONLY);
+	if (fd < 0) {
+		fprintf (stderr,
+			 "Can't open %s: %s\n",
+			 DEVNAME (dev_current), strerror (errno));
+		free (log);
+		return -1;
+	}
+	rc = flash_read_buf (dev_current, fd, log, size,
+			     DEVOFFSET (dev_current) + CUR_ENVSIZE,
+			     DEVTYPE (dev_current));
+	close (fd);
+	if (rc != size) {
+		free (log);
+		return -1;
+	}
+
+	for (off = 0; off + sizeof (rec) < size;
+	     off += (sizeof (rec) + rec.len + 3) & ~3) {
+		memcpy (&rec, log + off, sizeof (rec));
+		if (rec.base_crc != *environment.crc || !rec.len ||
+		    rec.len > size - off - sizeof (rec))
+			break;
+
+		p = log + off + sizeof (rec);
+		end = p + rec.len;
+		crc = crc32 (0, (uint8_t *) &rec.base_crc, sizeof (rec) -
+			     offsetof (struct env_log_rec, base_crc));
+		if (crc32 (crc, (uint8_t *) p, rec.len) != rec.crc ||
+		    end[-1] != '\0')
+			break;
+
+		/* "name=value" sets a variable, a bare "name" deletes it */
+		for (; p < end && *p; p = next) {
+			next = p + strlen (p) + 1;
+			value = strchr (p, '=');
+			if (value)
+				*value++ = '\0';
+			fw_env_write (p, value);
+		}
+	}
+
+	free (log);
+	return 0;
+}
+#endif
+
 /*
  * Prevent confusion if running from erased flash memory
  */
@@ -1226,6 +1332,10 @@ int fw_env_open(void)
 		fprintf(stderr, "Selected env in %s\n", DEVNAME(dev_current));
 #endif
 	}
+#ifdef CONFIG_ENV_LOG
+	if (env_log_replay ())
+		return -1;
+#endif
 	return 0;
 }
 
@@ -41,6 +41,7 @@
 #include <sys/mman.h>
 
 #include "compiler.h"
+#include <env_index.h>
 #include <u-boot/crc.h>
 #include <version.h>
 
@@ -48,7 +49,7 @@
 
 static void usage(const char *exec_name)
 {
-	fprintf(stderr, "%s [-h] [-r] [-b] [-p <byte>] -s <environment partition size> -o <output> <input file>\n"
+	fprintf(stderr, "%s [-h] [-r] [-b] [-p <byte>] [-i <entries>] -s <environment partition size> -o <output> <input file>\n"
 	       "\n"
 	       "This tool takes a key=value input file (same as would a `printenv' show) and generates the corresponding environment image, ready to be flashed.\n"
 	       "\n"
@@ -59,6 +60,7 @@ static void usage(const char *exec_name)
 	       "\t-r : the environment has multiple copies in flash\n"
 	       "\t-b : the target is big endian (default is little endian)\n"
 	       "\t-p <byte> : fill the image with <byte> bytes instead of 0xff bytes\n"
+	       "\t-i <entries> : add a CONFIG_ENV_INDEX index for a hash table of <entries>\n"
 	       "\t-V : print version information and exit\n"
 	       "\n"
 	       "If the input file is \"-\", data is read from standard input\n",
@@ -94,6 +96,7 @@ int main(int argc, char **argv)
 	int bigendian = 0;
 	int redundant = 0;
 	unsigned char padbyte = 0xff;
+	unsigned int index_entries = 0;
 
 	int option;
 	int ret = EXIT_SUCCESS;
@@ -109,7 +112,7 @@ int main(int argc, char **argv)
 	opterr = 0;
 
 	/* Parse the cmdline */
-	while ((option = getopt(argc, argv, ":s:o:rbp:hV")) != -1) {
+	while ((option = getopt(argc, argv, ":s:o:rbp:i:hV")) != -1) {
 		switch (option) {
 		case 's':
 			datasize = xstrtol(optarg);
@@ -130,6 +133,9 @@ int main(int argc, char **argv)
 		case 'p':
 			padbyte = xstrtol(optarg);
 			break;
+		case 'i':
+			index_entries = xstrtol(optarg);
+			break;
 		case 'h':
 			usage(prg);
 			return EXIT_SUCCESS;
@@ -282,6 +288,15 @@ int main(int argc, char **argv)
 		envptr[ep] = '\0';
 	}
 
+	if (index_entries) {
+		ret = env_index_build((char *)envptr, envsize, index_entries);
+		if (ret) {
+			fprintf(stderr, "Can't add the index: %s\n",
+				strerror(-ret));
+			return EXIT_FAILURE;
+		}
+	}
+
 	/* Computes the CRC and put it at the beginning of the data */
 	crc = crc32(0, envptr, envsize);
 	targetendian_crc = bigendian ? cpu_to_be32(crc) : cpu_to_le32(crc);
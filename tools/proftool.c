@@ -98,6 +98,8 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-flamegraph\tDump out folded stacks for flamegraph.pl\n"
+		"   dump-chrome\t\tDump out JSON for chrome://tracing\n"
 		"\n"
 		"Options:\n"
 		"   -m <map>\tSpecify Systen.map file\n"
@@ -544,6 +546,176 @@ static int make_ftrace(void)
 	return 0;
 }
 
+/* A function in the call tree built for a flame graph */
+struct flame_node {
+	struct func_info *func;		/* NULL for the root */
+	struct flame_node *parent;
+	struct flame_node *child;	/* first callee */
+	struct flame_node *next;	/* next callee of our parent */
+	unsigned long self_us;		/* time not spent in callees */
+};
+
+static struct flame_node *flame_child(struct flame_node *node,
+				      struct func_info *func)
+{
+	struct flame_node *child;
+
+	for (child = node->child; child; child = child->next) {
+		if (child->func == func)
+			return child;
+	}
+	child = calloc(1, sizeof(*child));
+	if (!child) {
+		error("Cannot allocate flame graph node\n");
+		exit(EXIT_FAILURE);
+	}
+	child->func = func;
+	child->parent = node;
+	child->next = node->child;
+	node->child = child;
+
+	return child;
+}
+
+/*
+ * Look up the function of an entry or exit record, or return NULL if it
+ * is unknown or excluded by the trace config. The time it spent is then
+ * charged to whatever called it.
+ */
+static struct func_info *call_func(struct trace_call *call,
+				   int *missing_count, int *skip_count)
+{
+	struct func_info *func = find_func_by_offset(call->func);
+
+	if (!func) {
+		warn("Cannot find function at %lx\n", text_offset + call->func);
+		(*missing_count)++;
+	} else if (!(func->flags & FUNCF_TRACE)) {
+		debug("Funcion '%s' is excluded from trace\n", func->name);
+		(*skip_count)++;
+		func = NULL;
+	}
+
+	return func;
+}
+
+static void flame_print(struct flame_node *node, char *stack, int len)
+{
+	struct flame_node *child;
+
+	if (node->func) {
+		int n = snprintf(stack + len, PATH_MAX - len, "%s%s",
+				 len ? ";" : "", node->func->name);
+
+		len = MIN(len + n, PATH_MAX - 1);
+		if (node->self_us)
+			printf("%s %lu\n", stack, node->self_us);
+	}
+	for (child = node->child; child; child = child->next)
+		flame_print(child, stack, len);
+}
+
+/*
+ * Folded stacks, one line per call path with the microseconds spent in
+ * its last function, as read by flamegraph.pl and speedscope:
+ *
+ * board_init_r;main_loop;run_command;do_hash 12
+ * board_init_r;main_loop;run_command;do_hash;hash_command;sha256_csum_wd 811
+ */
+static int make_flamegraph(void)
+{
+	struct flame_node root, *node, *up;
+	struct trace_call *call;
+	int missing_count = 0, skip_count = 0;
+	char stack[PATH_MAX];
+	ulong last = 0;
+	int started = 0;
+	int i;
+
+	memset(&root, '\0', sizeof(root));
+	node = &root;
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		ulong time = call->flags & FUNCF_TIMESTAMP_MASK;
+		struct func_info *func;
+
+		if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+		    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+		func = call_func(call, &missing_count, &skip_count);
+		if (!func)
+			continue;
+
+		if (started)
+			node->self_us += (time - last) & FUNCF_TIMESTAMP_MASK;
+		last = time;
+		started = 1;
+		if (TRACE_CALL_TYPE(call) == FUNCF_ENTRY) {
+			node = flame_child(node, func);
+			continue;
+		}
+
+		/*
+		 * Calls deeper than the trace depth limit were not recorded,
+		 * and neither were entries made before trace started, so an
+		 * exit may not match the innermost function.
+		 */
+		for (up = node; up != &root && up->func != func; up = up->parent)
+			;
+		if (up != &root)
+			node = up->parent;
+	}
+	stack[0] = '\0';
+	flame_print(&root, stack, 0);
+	info("flamegraph: %d functions not found, %d excluded\n",
+	     missing_count, skip_count);
+
+	return 0;
+}
+
+/*
+ * Chrome's trace event format, for chrome://tracing and Perfetto:
+ *
+ * {"traceEvents":[
+ * {"name":"do_hash","ph":"B","ts":1028115,"pid":1,"tid":1},
+ * {"name":"do_hash","ph":"E","ts":1029078,"pid":1,"tid":1}
+ * ]}
+ */
+static int make_chrome(void)
+{
+	struct trace_call *call;
+	int missing_count = 0, skip_count = 0;
+	unsigned long long ts = 0;
+	const char *sep = "";
+	ulong last = 0;
+	int i;
+
+	printf("{\"traceEvents\":[");
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		ulong time = call->flags & FUNCF_TIMESTAMP_MASK;
+		struct func_info *func;
+
+		if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+		    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+		func = call_func(call, &missing_count, &skip_count);
+		if (!func)
+			continue;
+
+		/* The timestamp is only 30 bits, so unwrap it */
+		ts = *sep ? ts + ((time - last) & FUNCF_TIMESTAMP_MASK) : time;
+		last = time;
+		printf("%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,"
+		       "\"pid\":1,\"tid\":1}", sep, func->name,
+		       TRACE_CALL_TYPE(call) == FUNCF_ENTRY ? 'B' : 'E', ts);
+		sep = ",";
+	}
+	printf("\n]}\n");
+	info("chrome: %d functions not found, %d excluded\n", missing_count,
+	     skip_count);
+
+	return 0;
+}
+
 static int prof_tool(int argc, char * const argv[],
 		     const char *prof_fname, const char *map_fname,
 		     const char *trace_config_fname)
@@ -564,6 +736,10 @@ static int prof_tool(int argc, char * const argv[],
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-flamegraph"))
+			err = make_flamegraph();
+		else if (0 == strcmp(cmd, "dump-chrome"))
+			err = make_chrome();
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}